@@ -2,9 +2,17 @@
 #define APPLICATION
 
 #include "../tools/imgui/imgui.h"
+#include "cycle/commandes.hpp"
+#include "cycle/instantane.hpp"
 #include "cycle/simulation.hpp"
 #include "utils.hpp"
 #include "window.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 
 class Application {
 public:
@@ -24,18 +32,65 @@ private:
   float cameraX;
   float cameraY;
   bool destroyClickRequested = false;
+  bool roadClickRequested = false;
   int clickMouseX = 0;
   int clickMouseY = 0;
   float speed;
   float taskbarHeight;
   bool isDestroying;
+  bool isPlacingRoad = false;
+
+  // Simulation thread: it owns sim while verrouSimulation is held, the
+  // interface only sees published snapshots and sends commands
+  static constexpr int MAP_ROWS = 64;
+  static constexpr int MAP_COLS = 64;
+  static constexpr int TILE_COUNT = 25;
+  // The simulation advances by fixed steps; after a stall at most
+  // MAX_CATCH_UP_STEPS are replayed and the rest of the lost time dropped
+  static constexpr double SIM_STEP = 1.0 / 60.0;
+  static constexpr int MAX_CATCH_UP_STEPS = 5;
+  std::thread simulationThread;
+  std::atomic<bool> simulationRunning{false};
+  mutable std::mutex verrouSimulation;
+  FileCommandes commandes;
+  // Commands the queue had no room for, sent again on the next frame in the
+  // order they were issued (UI thread only)
+  std::deque<Commande> commandesEnAttente;
+  TamponInstantanes instantanes;
+  std::shared_ptr<const Instantane> dernierInstantane; // sim thread only
+  double dureeDernierPas = 0.0;                        // sim thread only
+
+  void simulationLoop();
+  void appliquerCommande(const Commande &commande);
+  void envoyerCommande(const Commande &commande);
+  void envoyerCommandesEnAttente();
+  void publierInstantane(Uint64 horodatage);
+  void stopSimulation();
+
+  // Performance overlay, counters filled by run() every frame
+  static constexpr int FRAME_HISTORY = 240;
+  bool showPerformance = false;
+  float frameTimes[FRAME_HISTORY] = {};
+  int frameIndex = 0;
+  int frameCount = 0; // samples recorded, up to FRAME_HISTORY
+  int drawCalls = 0;
+  int tilesDrawn = 0;
+  int tilesCulled = 0;
+
+  // History window
+  bool showHistory = false;
+  int historyLevel = 0;
+  std::string historyExport; // result of the last export
 
   // for run() method
   void checkEvent();
   void displayInspect(ImGuiWindowFlags flags, float x, float y, int value,
                       bool isHoveringRect, float speed, float recwidth) const;
-  void displayTaskBar(ImGuiWindowFlags flags, Simulation &);
-  void displayToolkit(ImGuiWindowFlags flags);
+  void displayTaskBar(ImGuiWindowFlags flags, const Instantane &etat,
+                      float tempsCycle);
+  void displayToolkit(ImGuiWindowFlags flags, const Instantane &etat);
+  void displayPerformance(const Instantane &etat);
+  void displayHistory(const Instantane &etat);
 };
 
 #endif // !APPLICATION
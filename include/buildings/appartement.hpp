@@ -5,13 +5,13 @@
 
 class Appartement : public Resident {
 private:
-  Appartement(int id, const std::string &nom, Ville *ville, TypeBatiment type,
+  Appartement(int id, std::string_view nom, Ville *ville, TypeBatiment type,
               int effectSatisfication, double cost, Resources consommation,
               float polution, Position position, Surface surface,
               int capaciteHabitants, int habitantsActuels,
               unsigned int floorsCount);
 
-  Appartement(int id, const std::string &nom, Ville *ville, TypeBatiment type,
+  Appartement(int id, std::string_view nom, Ville *ville, TypeBatiment type,
               int effectSatisfication, double cost, double consommationEau,
               double consommationElectricte, float polution, int x, int y,
               int largeur, int longeur, int capaciteHabitants,
@@ -29,7 +29,7 @@ protected:
   static constexpr int EFFET_SATISFACTION_PER_FLOOR = 1.0;
 
 public:
-  static Appartement createAppartement(int id, const string &nom, Ville *ville,
+  static Appartement createAppartement(int id, string_view nom, Ville *ville,
                                        unsigned int floorNumbers, int x, int y);
   void addNewFloor();
   void destroyFloor();
@@ -11,6 +11,8 @@
 using namespace std;
 
 class Batiment {
+  friend class Ville; // hands out the ids and rows
+
 public:
   TypeBatiment type;
   Surface surface;
@@ -24,26 +26,25 @@ public:
   static float POPULATION_BUILDING_FACTOR;         // Comment la population affecte les besoins en bâtiments
   
   // Constructors
-  Batiment(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Batiment(int id, string_view nom, Ville *ville, TypeBatiment type,
            int effectSatisfication, double cost, double consommationEau,
            double consommationElectricite, float polution, int x, int y,
            int largeur, int longeur);
 
-  Batiment(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Batiment(int id, string_view nom, Ville *ville, TypeBatiment type,
            int effectSatisfication, double cost, Resources consommation,
            float polution, Position position, Surface surface);
   virtual ~Batiment() = default;
 
   virtual void afficheDetails() const;
-  virtual void impacterRessources();
 
   // Getters
-  int getID();
+  int getID(); // handle in the city's TableHandles, 0 outside a city
   double getCost();
   int getSatisfaction();
   float getPolution();
   Resources getconsommation();
-  string getNom() const;  // Getter for building name
+  string_view getNom() const;  // Getter for building name (interned)
 
   // Setters 
   static void setPollutionSatisfactionFactor(float factor);
@@ -53,7 +54,9 @@ public:
 
 protected:
   int id;
-  string nom;
+  uint32_t ligne = 0; // row in the city's ColonnesBatiments
+  uint32_t rangEmployeur = 0; // index in the city's employer list
+  NomId nom; // in TableNoms
   Resources consommation;
   float polution;
   int effectSatisfication;
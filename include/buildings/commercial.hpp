@@ -8,13 +8,13 @@ using namespace std;
 class Comercial : public Service {
 protected:
   // Constructors
-  Comercial(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Comercial(int id, string_view nom, Ville *ville, TypeBatiment type,
             int effectSatisfication, double cost, unsigned int employees,
             unsigned int employeesNeeded, double consommationEau,
             double consommationElectricite, float polution, int x, int y,
             int largeur, int longeur, double profit);
 
-  Comercial(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Comercial(int id, string_view nom, Ville *ville, TypeBatiment type,
             int effectSatisfication, double cost, unsigned int employees,
             unsigned int employeesNeeded, Resources consommation,
             float polution, Position position, Surface surface, double profit);
@@ -44,7 +44,8 @@ public:
   static BatPtr createBank(Ville *ville, int x, int y);
 
   // Getters
-  double getProfit();
+  double getProfit() const; // with the city's last pollution factor
+  double getProfitBase() const; // before staffing and pollution
 
 private:
   double profit;
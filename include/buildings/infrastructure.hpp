@@ -8,13 +8,13 @@ using namespace std;
 
 class Infrastructure : public Service {
 protected:
-  Infrastructure(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Infrastructure(int id, string_view nom, Ville *ville, TypeBatiment type,
                  int effectSatisfication, double cost, unsigned int employees,
                  unsigned int employeesNeeded, double consommationEau,
                  double consommationElectricite, double pollution,
                  Position position, Surface surface,
                  Resources productionRessources);
-  Infrastructure(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Infrastructure(int id, string_view nom, Ville *ville, TypeBatiment type,
                  int effectSatisfication, double cost, unsigned int employees,
                  unsigned int employeesNeeded, double consommationEau,
                  double consommationElectricite, double pollution, int x, int y,
@@ -24,16 +24,15 @@ protected:
 
 public:
   // Methods
-  void produireRessources();
-  void impacterRessources() override;
   double calculerPollution(); // TO-DO
 
-  static Infrastructure createPowerPlant(int id, const string &nom,
-                                         Ville *ville, int x, int y);
-  static Infrastructure createWaterTreatmentPlant(int id, const string &nom,
-                                                  Ville *ville, int x, int y);
-  static Infrastructure createUtilityPlant(int id, const string &nom,
-                                           Ville *ville, int x, int y);
+  static BatPtr createPowerPlant(Ville *ville, int x, int y);
+  static BatPtr createWaterTreatmentPlant(Ville *ville, int x, int y);
+  static BatPtr createUtilityPlant(Ville *ville, int x, int y);
+
+  // Getters
+  Resources getProduction() const;
+  Resources getProductionEffective() const; // scaled by staffing
 };
 
 #endif // !INFRASTRUCTURE
@@ -9,12 +9,12 @@ using namespace std;
 class Parc : public Service {
 protected:
   // Constructors
-  Parc(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Parc(int id, string_view nom, Ville *ville, TypeBatiment type,
        int effectSatisfication, double cost, unsigned int Employees,
        unsigned int EmployeesNeeded, Resources consommation, float polution,
        Position position, Surface surface);
 
-  Parc(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Parc(int id, string_view nom, Ville *ville, TypeBatiment type,
        int effectSatisfication, double cost, unsigned int Employees,
        unsigned int EmployeesNeeded, double consommationEau,
        double consommationElectricite, float polution, int x, int y,
@@ -24,7 +24,7 @@ public:
   // Methods
   void afficheDetails() const override;
   void ameliorerBienEtre();
-  void diminuerPollution();
+  void diminuerPollution(); // registers the park as a pollution sink
 
   // Factory method for creating parks
   static BatPtr createPark(Ville *ville, int x, int y);
@@ -8,13 +8,13 @@ using namespace std;
 class Resident : public Batiment {
 protected:
   // Constructors
-  Resident(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Resident(int id, string_view nom, Ville *ville, TypeBatiment type,
            int effectSatisfication, double cost, double consommationEau,
            double consommationElectricite, float polution, int x, int y,
            int largeur, int longeur, int capaciteHabitants,
            int habitantsActuels);
 
-  Resident(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Resident(int id, string_view nom, Ville *ville, TypeBatiment type,
            int effectSatisfication, double cost, Resources consommation,
            float polution, Position position, Surface surface,
            int capaciteHabitants, int habitantsActuels);
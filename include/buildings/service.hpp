@@ -8,13 +8,13 @@ using namespace std;
 class Service : public Batiment {
 protected:
   // Constructors
-  Service(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Service(int id, string_view nom, Ville *ville, TypeBatiment type,
           int effectSatisfication, double cost, unsigned int Employees,
           unsigned int EmployeesNeeded, double consommationEau,
           double consommationElectricite, float polution, int x, int y,
           int largeur, int longeur);
 
-  Service(int id, const string &nom, Ville *ville, TypeBatiment type,
+  Service(int id, string_view nom, Ville *ville, TypeBatiment type,
           int effectSatisfication, double cost, unsigned int Employees,
           unsigned int EmployeesNeeded, Resources consommation, float polution,
           Position position, Surface surface);
@@ -0,0 +1,82 @@
+#ifndef TRAITS
+#define TRAITS
+
+#include "../utils.hpp"
+#include "../ville/agrements.hpp"
+#include <algorithm>
+#include <array>
+
+// What the simulation and the renderer know about a kind of building
+// without looking at an instance. One row per TypeBatiment, in enum order.
+struct TraitsBatiment {
+  const char *nom;   // display name and metrics label
+  int longeur;       // footprint in tiles along x
+  int largeur;       // footprint in tiles along y
+  int tuile;         // atlas tile of the top-left corner
+  float pollution;   // contribution to the city-wide pollution
+  bool agrement;     // counts as an amenity for nearby homes
+  Agrement categorie; // kind of amenity, when agrement is set
+  bool employeur;    // hires residents
+  bool residence;    // houses residents
+  bool centrale;     // produces water or electricity
+};
+
+// Tile atlas rows are this wide, footprints use consecutive rows
+inline constexpr int COLONNES_ATLAS = 5;
+inline constexpr int TUILE_HERBE = 6;
+
+// Satisfaction bonus for a home fully covered by one kind of amenity
+inline constexpr float BONUS_AGREMENT[CarteAgrements::NOMBRE] = {
+    8.0f, // Parc: parks improve happiness
+    5.0f, // Commerce: shops and leisure
+    2.0f, // Service: utilities nearby
+};
+
+inline constexpr std::array<TraitsBatiment, NOMBRE_TYPES_BATIMENT>
+    TRAITS_BATIMENTS = {{
+        // nom, longeur, largeur, tuile, pollution,
+        // agrement, categorie, employeur, residence, centrale
+        {"Blank", 1, 1, TUILE_HERBE, 0.0f,
+         false, Agrement::Parc, false, false, false},
+        {"House", 1, 1, 0, 2.0f,
+         false, Agrement::Parc, false, true, false},
+        {"Apartment", 1, 1, 1, 2.0f,
+         false, Agrement::Parc, false, true, false},
+        {"Bank", 1, 1, 2, 5.0f,
+         true, Agrement::Commerce, true, false, false},
+        {"PowerPlant", 1, 1, 3, 15.0f,
+         true, Agrement::Service, true, false, true},
+        {"WaterTreatmentPlant", 1, 1, 4, 0.0f,
+         true, Agrement::Service, true, false, true},
+        {"UtilityPlant", 1, 1, 5, 0.0f,
+         true, Agrement::Service, false, false, true},
+        {"Park", 2, 2, 15, 0.0f,
+         true, Agrement::Parc, true, false, false},
+        {"Cinema", 2, 1, 10, 5.0f,
+         true, Agrement::Commerce, true, false, false},
+        {"Mall", 3, 3, 12, 5.0f,
+         true, Agrement::Commerce, true, false, false},
+        {"Custom", 1, 1, TUILE_HERBE, 0.0f,
+         false, Agrement::Parc, false, false, false},
+    }};
+
+static_assert(std::all_of(TRAITS_BATIMENTS.begin(), TRAITS_BATIMENTS.end(),
+                          [](const TraitsBatiment &t) {
+                            return t.nom && t.longeur > 0 && t.largeur > 0 &&
+                                   t.longeur <= COLONNES_ATLAS;
+                          }),
+              "every building type needs a row in TRAITS_BATIMENTS");
+
+// Widest footprint along either axis, for searches around a building
+inline constexpr int EMPRISE_MAX = [] {
+  int emprise = 1;
+  for (const TraitsBatiment &t : TRAITS_BATIMENTS)
+    emprise = std::max({emprise, t.longeur, t.largeur});
+  return emprise;
+}();
+
+constexpr const TraitsBatiment &traitsDe(TypeBatiment type) {
+  return TRAITS_BATIMENTS[static_cast<size_t>(type)];
+}
+
+#endif // !TRAITS
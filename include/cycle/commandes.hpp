@@ -0,0 +1,40 @@
+#ifndef COMMANDES
+#define COMMANDES
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// User action sent from the interface to the simulation thread
+struct Commande {
+  enum class Type {
+    Detruire,     // building at (x, y), or the road there
+    AjouterRoute, // at (x, y)
+    TerminerCycle,
+    ModeTrajet,
+    Trafic,
+    Repartie,
+    CycleParallele
+  };
+  Type type = Type::TerminerCycle;
+  int x = 0;
+  int y = 0;
+  bool actif = false;
+};
+
+// Lock-free ring buffer with a single producer (the interface) and a
+// single consumer (the simulation thread)
+class FileCommandes {
+public:
+  static constexpr std::size_t CAPACITE = 256;
+
+  bool pousser(const Commande &commande); // false when full
+  bool extraire(Commande &commande);      // false when empty
+
+private:
+  std::array<Commande, CAPACITE> tampon;
+  alignas(64) std::atomic<std::size_t> tete{0};  // next slot to read
+  alignas(64) std::atomic<std::size_t> queue{0}; // next slot to write
+};
+
+#endif // !COMMANDES
@@ -0,0 +1,53 @@
+#ifndef HISTORIQUE
+#define HISTORIQUE
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+// City figures at the end of a cycle, or averaged over a period
+struct Releve {
+  int cycle = 0; // last cycle of the period
+  float budget = 0.0f;
+  float population = 0.0f;
+  float satisfaction = 0.0f;
+  float pollution = 0.0f;
+  float chomage = 0.0f; // unemployment, %
+  int evenement = -1;   // id of the last event of the period, -1 if none
+};
+
+// Per-cycle history kept in fixed ring buffers, so memory stays bounded
+// however long the run. Level 0 holds the last CAPACITE cycles, each
+// following level averages FACTEUR rows of the previous one and so covers
+// a FACTEUR times longer span.
+class Historique {
+public:
+  static constexpr int NIVEAUX = 3; // 1x, 10x, 100x
+  static constexpr int FACTEUR = 10;
+  static constexpr size_t CAPACITE = 1024; // rows per level
+
+  void enregistrer(const Releve &releve);
+
+  size_t taille(int niveau) const;
+  const Releve &get(int niveau, size_t i) const; // i = 0 is the oldest
+  int getPeriode(int niveau) const;              // cycles per row
+  unsigned long getNombreReleves() const;
+
+  // One row per line: cycle,budget,population,...; false if unwritable
+  bool exporterCSV(const std::string &chemin, int niveau) const;
+
+private:
+  struct Niveau {
+    std::array<Releve, CAPACITE> releves;
+    size_t debut = 0;
+    size_t taille = 0;
+    Releve somme; // rows waiting to be averaged into the next level
+    int cumules = 0;
+  };
+  std::array<Niveau, NIVEAUX> niveaux;
+  unsigned long nombreReleves = 0;
+
+  void ajouter(int niveau, const Releve &releve);
+};
+
+#endif // !HISTORIQUE
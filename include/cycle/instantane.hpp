@@ -0,0 +1,61 @@
+#ifndef INSTANTANE
+#define INSTANTANE
+
+#include "../utils.hpp"
+#include "historique.hpp"
+#include "statistiques.hpp"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Read-only picture of the simulation handed to the renderer. Map layers
+// are shared between snapshots until the city changes; tuilesModifiees
+// lists the tiles that differ from the snapshot of revisionPrecedente so
+// the renderer can patch its tilemap instead of rebuilding it.
+struct Instantane {
+  // City, shared until the next cycle or edit
+  std::shared_ptr<const CityStats> stats;
+  std::shared_ptr<const Historique> historique;
+
+  // Cycle
+  float tempsCycle = 0.0f;
+  float dureeCycle = 0.0f;
+  bool enCours = false;    // the cycle timer is running
+  double horodatage = 0.0; // seconds (performance counter) of the last step
+
+  // Timings, in ms
+  double dureePas = 0.0; // slowest simulation step of the last wake up
+  std::vector<std::pair<std::string, double>> dureesPhases; // last cycle end
+
+  // Options
+  bool modeTrajet = false;
+  bool trafic = false;
+  bool repartie = false;
+  bool cycleParallele = false;
+
+  // Map
+  int largeur = 0;
+  int hauteur = 0;
+  unsigned long revision = 0;
+  unsigned long revisionPrecedente = 0;
+  std::shared_ptr<const std::vector<int>> tuiles; // building tile, -1 if none
+  std::shared_ptr<const std::vector<unsigned char>> routes;
+  std::vector<int> tuilesModifiees;
+};
+
+// Latest published snapshot. The simulation fills the next one while the
+// renderer keeps reading the current one, then the pointer is swapped; the
+// lock only covers that swap, never the snapshot contents.
+class TamponInstantanes {
+public:
+  void publier(std::shared_ptr<const Instantane> instantane);
+  std::shared_ptr<const Instantane> lire() const;
+
+private:
+  mutable std::mutex verrou;
+  std::shared_ptr<const Instantane> courant;
+};
+
+#endif // !INSTANTANE
@@ -0,0 +1,70 @@
+#ifndef METRIQUES
+#define METRIQUES
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+// Counters and gauges of a running simulation. Entries are appended by a
+// single owner thread and never removed; values are atomics, so neither
+// updating nor reading them takes a lock and a scrape cannot stall the
+// simulation.
+class RegistreMetriques {
+public:
+  enum class Genre { Compteur, Jauge };
+  static constexpr size_t CAPACITE = 128;
+
+  // Index of the new entry, CAPACITE if full. Entries of the same name
+  // (differing by their labels, e.g. `phase="jobs"`) must be consecutive.
+  size_t enregistrer(Genre genre, const std::string &nom,
+                     const std::string &aide,
+                     const std::string &etiquettes = "");
+
+  void ajouter(size_t metrique, double valeur);
+  void fixer(size_t metrique, double valeur);
+  double lire(size_t metrique) const;
+  size_t taille() const;
+
+  // Prometheus text exposition format
+  std::string exporter() const;
+
+private:
+  struct Metrique {
+    Genre genre = Genre::Compteur;
+    std::string nom;
+    std::string aide;
+    std::string etiquettes;
+    std::atomic<double> valeur{0.0};
+  };
+  std::array<Metrique, CAPACITE> metriques;
+  std::atomic<size_t> nombre{0};
+};
+
+// Minimal HTTP endpoint answering GET /metrics on 127.0.0.1 from its own
+// thread
+class ServeurMetriques {
+public:
+  explicit ServeurMetriques(const RegistreMetriques &registre);
+  ~ServeurMetriques();
+  ServeurMetriques(const ServeurMetriques &) = delete;
+  ServeurMetriques &operator=(const ServeurMetriques &) = delete;
+
+  // Port 0 picks a free one; false if the socket cannot be opened
+  bool demarrer(unsigned short port);
+  void arreter();
+  unsigned short getPort() const;
+
+private:
+  const RegistreMetriques &registre;
+  std::thread fil;
+  std::atomic<bool> actif{false};
+  int socketEcoute = -1;
+  unsigned short port = 0;
+
+  void boucle();
+  void repondre(int client) const;
+};
+
+#endif // !METRIQUES
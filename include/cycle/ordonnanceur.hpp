@@ -0,0 +1,81 @@
+#ifndef ORDONNANCEUR
+#define ORDONNANCEUR
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool shared by the whole program. Each worker keeps its own
+// queue and runs the newest task first; idle workers steal the oldest task
+// of another queue. A thread waiting for tasks (aiderJusqua) runs queued
+// work meanwhile, so nested parallel sections never deadlock, and sleeps
+// when there is nothing to take until a task ends or a new one comes in.
+class PoolTravail {
+public:
+  static PoolTravail &instance();
+
+  explicit PoolTravail(unsigned int nombreThreads);
+  ~PoolTravail();
+  PoolTravail(const PoolTravail &) = delete;
+  PoolTravail &operator=(const PoolTravail &) = delete;
+
+  void soumettre(std::function<void()> tache);
+  void aiderJusqua(const std::function<bool()> &termine);
+  unsigned int getNombreThreads() const; // workers, callers come on top
+
+private:
+  struct File {
+    std::mutex verrou;
+    std::deque<std::function<void()>> taches;
+  };
+
+  std::vector<std::unique_ptr<File>> files; // one per worker + one shared
+  std::vector<std::thread> threads;
+  std::atomic<size_t> enAttente{0};
+  std::atomic<bool> arret{false};
+  std::atomic<unsigned int> prochaineFile{0};
+  std::mutex verrouReveil;
+  std::condition_variable reveil; // workers
+  std::condition_variable fin;    // threads in aiderJusqua
+  size_t aidants = 0;             // sleeping on fin, under verrouReveil
+
+  bool executerUne(size_t index);
+  void reveillerAidants();
+  void boucle(size_t index);
+  size_t fileCourante() const;
+};
+
+// Phases with declared dependencies. Phases must be added after the ones
+// they depend on (ajouter throws std::invalid_argument otherwise);
+// executer(false) then runs them in insertion order, which is the reference
+// serial path. executer(true) starts every phase as soon
+// as its dependencies are done, on the pool.
+class GrapheTaches {
+public:
+  int ajouter(const std::string &nom, std::function<void()> tache,
+              std::initializer_list<int> dependances = {});
+  void executer(bool parallele);
+
+  size_t taille() const;
+  const std::string &getNom(int phase) const;
+  double getDuree(int phase) const; // ms, last execution
+
+private:
+  struct Phase {
+    std::string nom;
+    std::function<void()> tache;
+    std::vector<int> suivantes;
+    int dependances = 0;
+    double duree = 0.0;
+  };
+  std::vector<Phase> phases;
+};
+
+#endif // !ORDONNANCEUR
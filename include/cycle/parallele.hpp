@@ -0,0 +1,12 @@
+#ifndef PARALLELE
+#define PARALLELE
+
+#include <cstddef>
+#include <functional>
+
+// Runs tache(i) for every i in [0, nombre) across the available cores.
+// Returns once every task has finished; small batches run inline.
+void executerEnParallele(std::size_t nombre,
+                         const std::function<void(std::size_t)> &tache);
+
+#endif // !PARALLELE
@@ -4,7 +4,14 @@
 #include "../utils.hpp"
 #include "../ville/ville.hpp"
 #include "../evenement.hpp"
+#include "historique.hpp"
+#include "metriques.hpp"
+#include "statistiques.hpp"
+#include <chrono>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -20,6 +27,9 @@ public:
   void declencherEvenement();
   void tick(float delta);
   bool canInteract() const;
+  // Run the end of cycle phases concurrently (same results as serially)
+  void setCycleParallele(bool actif);
+  bool getCycleParallele() const;
 
   // Getters
   int getCycle() const;
@@ -29,6 +39,18 @@ public:
   const Ville& getVille() const;
   Ville& getVille();
   const Evenement* getEvenementActuel() const;
+  // Duration in ms of each phase of the last end of cycle
+  const vector<pair<string, double>>& getDureesPhases() const;
+  // Figures of the city as of the last publierStats()
+  shared_ptr<const CityStats> getStats() const;
+  void publierStats(); // to call after editing the city
+  // Figures recorded at the end of every cycle
+  const Historique& getHistorique() const;
+  // Copy for other threads, only redone after a new cycle was recorded
+  shared_ptr<const Historique> partagerHistorique();
+  // Serves the metrics below on http://127.0.0.1:port/metrics
+  bool exposerMetriques(unsigned short port);
+  const RegistreMetriques& getMetriques() const;
 
 private:
   Ville ville;
@@ -37,10 +59,33 @@ private:
   float TimePerCycle;
   float currentTime;
   SimState state;
+  bool cycleParallele = true;
+  vector<pair<string, double>> dureesPhases;
+  shared_ptr<const CityStats> stats;
+  Historique historique;
+  shared_ptr<const Historique> historiquePartage;
+
+  // Metrics, indices into the registry
+  RegistreMetriques metriques;
+  unique_ptr<ServeurMetriques> serveurMetriques;
+  size_t metriqueCycles;
+  size_t metriqueCyclesParSeconde;
+  size_t metriquePopulation;
+  size_t metriqueBudget;
+  size_t metriqueBatiments; // first of one per TypeBatiment
+  size_t metriqueAjoutes;
+  size_t metriqueRetires;
+  size_t metriqueEvenements; // first of one per EventCategory
+  vector<size_t> metriquesPhases;
+  chrono::steady_clock::time_point finCyclePrecedent;
   
   // Event system
   EventManager eventManager;
   std::unique_ptr<Evenement> evenementActuel;
+
+  void enregistrerHistorique();
+  void enregistrerMetriques();
+  void actualiserMetriques();
 };
 
 #endif // !SIMULATION
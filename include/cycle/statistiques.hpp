@@ -0,0 +1,20 @@
+#ifndef STATISTIQUES
+#define STATISTIQUES
+
+#include <string>
+
+// City figures shown by the interface. Simulation rebuilds them when a
+// cycle ends or starts and after an edit, readers share the same copy
+// until then instead of querying the city every frame.
+struct CityStats {
+  std::string nom;
+  unsigned int population = 0;
+  unsigned int emploiActuel = 0;
+  unsigned int capaciteEmploi = 0;
+  float tauxChomage = 0.0f;
+  int satisfaction = 0;
+  double budget = 0.0;
+  int cycle = 0;
+};
+
+#endif // !STATISTIQUES
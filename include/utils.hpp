@@ -1,8 +1,15 @@
 #ifndef UTILS
 #define UTILS
 
+#include <array>
+#include <cstdint>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <random>
 #include <map>
@@ -100,38 +107,71 @@ enum class TypeBatiment {
   Mall, //9
   Custom //10
 };
+constexpr size_t NOMBRE_TYPES_BATIMENT =
+    static_cast<size_t>(TypeBatiment::Custom) + 1;
 
 enum class SimState { Running, Evaluating, GameOver };
 enum class Difficulty { Easy, Medium, Hard };
 
-using BatPtr = std::unique_ptr<Batiment>;
+// Gives a building back to where it was allocated: the arena of its Ville
+// (see ville/arene.hpp), or the heap for buildings made with plain new
+struct SuppressionBatiment {
+  void (*liberer)(void *pool, Batiment *batiment) = nullptr;
+  void *pool = nullptr;
+
+  SuppressionBatiment() = default;
+  SuppressionBatiment(void (*liberer)(void *, Batiment *), void *pool)
+      : liberer(liberer), pool(pool) {}
+  template <class T> SuppressionBatiment(const std::default_delete<T> &) {}
+  void operator()(Batiment *batiment) const;
+};
+
+using BatPtr = std::unique_ptr<Batiment, SuppressionBatiment>;
 using BatimentList = std::vector<BatPtr>;
 
-// Générateur d'IDs - déclaration seulement
-class BuildingIDGenerator {
+// Noms internés : chaque nom distinct n'est stocké qu'une fois et les
+// bâtiments n'en gardent que l'identifiant. Les vues restent valides
+// jusqu'à la fin du programme. Seul interner() prend le verrou : les noms
+// sont rangés dans des blocs qui ne bougent jamais et get() lit sans
+// verrou ceux déjà publiés.
+using NomId = uint32_t;
+
+class TableNoms {
 private:
-    static std::hash<std::string> string_hasher;
-    static std::random_device rd;
-    static std::mt19937 gen;
-    static std::uniform_int_distribution<int> dist;
+    static constexpr size_t TAILLE_BLOC = 1024;
+    static constexpr size_t NOMBRE_BLOCS = 4096;
+
+    static std::shared_mutex verrou; // pour index et l'ajout de noms
+    static std::array<std::unique_ptr<std::string[]>, NOMBRE_BLOCS> blocs;
+    static std::atomic<NomId> publies; // noms lisibles par get()
+    static std::unordered_map<std::string_view, NomId> index;
 
 public:
-    static int generateID(const std::string& name, TypeBatiment type, 
-                         const Position& position, const Surface& surface);
+    static NomId interner(std::string_view nom);
+    static std::string_view get(NomId id);
+    static size_t taille();
 };
 
-// Générateur de noms - déclaration seulement
+// Générateur de noms - déclaration seulement. Les noms sont rangés par
+// type dans un tableau et pointent dans TableNoms : un tirage n'est qu'un
+// accès au tableau, sans fichier ni verrou. Chaque thread tire avec son
+// propre générateur.
 class NameGenerator {
 private:
-    static std::map<TypeBatiment, std::vector<std::string>> buildingNames;
-    static std::random_device rd;
-    static std::mt19937 gen;
-    static bool initialized;
+    static std::array<std::vector<std::string_view>, NOMBRE_TYPES_BATIMENT>
+        buildingNames;
+    static std::once_flag initialisation;
+    static std::atomic<bool> pret; // noms rangés, tirages permis
 
-    static void initializeNames();
+    static void chargerNoms();
 
 public:
-    static std::string getRandomName(TypeBatiment type);
+    // Lit building-names.json une seule fois, même appelé depuis plusieurs
+    // threads ; la simulation l'appelle à son démarrage
+    static void initializeNames();
+    // Lance std::logic_error si initializeNames() n'a pas été appelé : un
+    // tirage ne lit jamais le disque
+    static std::string_view getRandomName(TypeBatiment type); // interné
 };
 
 #endif // !UTILS
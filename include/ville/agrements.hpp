@@ -0,0 +1,50 @@
+#ifndef AGREMENTS
+#define AGREMENTS
+
+#include "../utils.hpp"
+#include <array>
+#include <vector>
+
+enum class Agrement { Parc, Commerce, Service };
+
+// Per-tile amenity coverage: how many parks, shops and utility plants lie
+// within a square neighbourhood of each tile. Computed with a separable
+// box filter (horizontal then vertical running sums) and only over the
+// region touched by buildings added or removed since the last update.
+class CarteAgrements {
+public:
+  static constexpr int NOMBRE = 3;
+  static constexpr std::array<int, NOMBRE> RAYONS = {6, 10, 12};
+
+  explicit CarteAgrements(int largeur = 0, int hauteur = 0);
+
+  void redimensionner(int largeur, int hauteur);
+  void ajouter(Agrement agrement, Position position, Surface surface);
+  void retirer(Agrement agrement, Position position, Surface surface);
+
+  void actualiser(); // recompute dirty regions
+  float couverture(Agrement agrement, int x, int y) const;
+
+private:
+  struct Zone {
+    int x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+    bool vide() const { return x1 < x0 || y1 < y0; }
+  };
+
+  struct Couche {
+    std::vector<float> sources;     // amenity weight per tile
+    std::vector<float> horizontale; // box sum along x
+    std::vector<float> couverture;  // box sum along x then y
+    Zone modifiee;
+  };
+
+  int largeur;
+  int hauteur;
+  std::array<Couche, NOMBRE> couches;
+
+  void deposer(Agrement agrement, Position position, Surface surface,
+               float poids);
+  void actualiserCouche(Couche &couche, int rayon);
+};
+
+#endif // !AGREMENTS
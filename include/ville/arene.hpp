@@ -0,0 +1,122 @@
+#ifndef ARENE
+#define ARENE
+
+#include "../buildings/commercial.hpp"
+#include "../buildings/infrastructure.hpp"
+#include "../buildings/parc.hpp"
+#include "../buildings/resident.hpp"
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+// Objects of one type carved out of blocks of TAILLE_BLOC slots, so the
+// buildings of a type sit next to each other in memory. Freed slots are
+// chained and reused first; blocks are only given back with the pool.
+template <class T> class PoolObjets {
+public:
+  static constexpr size_t TAILLE_BLOC = 256;
+
+  PoolObjets() = default;
+  PoolObjets(const PoolObjets &) = delete;
+  PoolObjets &operator=(const PoolObjets &) = delete;
+
+  void *allouer() {
+    ++vivants;
+    if (libre) {
+      Emplacement *emplacement = libre;
+      libre = emplacement->suivant;
+      return emplacement->objet;
+    }
+    if (blocs.empty() || utilises == TAILLE_BLOC) {
+      blocs.push_back(std::make_unique<Bloc>());
+      utilises = 0;
+    }
+    return blocs.back()->emplacements[utilises++].objet;
+  }
+
+  void liberer(void *objet) {
+    Emplacement *emplacement = static_cast<Emplacement *>(objet);
+    emplacement->suivant = libre;
+    libre = emplacement;
+    --vivants;
+  }
+
+  size_t getVivants() const { return vivants; }
+  size_t getCapacite() const { return blocs.size() * TAILLE_BLOC; }
+
+private:
+  union Emplacement {
+    Emplacement *suivant;
+    alignas(T) unsigned char objet[sizeof(T)];
+  };
+  struct Bloc {
+    Emplacement emplacements[TAILLE_BLOC];
+  };
+
+  std::vector<std::unique_ptr<Bloc>> blocs;
+  size_t utilises = 0; // slots handed out from the last block
+  Emplacement *libre = nullptr;
+  size_t vivants = 0;
+};
+
+// Storage of a city's buildings, one pool per concrete building class.
+// Deleting a building only chains its slot, and a city going away releases
+// whole blocks. Not thread-safe, like the rest of Ville.
+class AreneBatiments {
+public:
+  // construire(place) builds the object at place with placement new; the
+  // factories supply it so the constructors can stay private
+  template <class T, class F> BatPtr creer(F &&construire) {
+    PoolObjets<T> &pool = std::get<PoolObjets<T>>(pools);
+    void *place = pool.allouer();
+    T *objet;
+    try {
+      objet = construire(place);
+    } catch (...) {
+      pool.liberer(place);
+      throw;
+    }
+    return BatPtr(objet, SuppressionBatiment(&liberer<T>, &pool));
+  }
+
+  size_t getNombreObjets() const;
+  size_t getCapacite() const;
+
+private:
+  std::tuple<PoolObjets<Resident>, PoolObjets<Comercial>, PoolObjets<Parc>,
+             PoolObjets<Infrastructure>>
+      pools;
+
+  template <class T> static void liberer(void *pool, Batiment *batiment) {
+    T *objet = static_cast<T *>(batiment);
+    objet->~T();
+    static_cast<PoolObjets<T> *>(pool)->liberer(objet);
+  }
+  template <class T> static void libererTas(void *, Batiment *batiment) {
+    T *objet = static_cast<T *>(batiment);
+    objet->~T();
+    ::operator delete(objet);
+  }
+
+  template <class T, class F>
+  friend BatPtr creerBatiment(Ville *ville, F &&construire);
+};
+
+// Building of class T from ville's arena, or from the heap without a city
+template <class T, class F> BatPtr creerBatiment(Ville *ville, F &&construire) {
+  if (ville)
+    return ville->getArene().creer<T>(std::forward<F>(construire));
+  void *place = ::operator new(sizeof(T));
+  T *objet;
+  try {
+    objet = construire(place);
+  } catch (...) {
+    ::operator delete(place);
+    throw;
+  }
+  return BatPtr(objet,
+                SuppressionBatiment(&AreneBatiments::libererTas<T>, nullptr));
+}
+
+#endif // !ARENE
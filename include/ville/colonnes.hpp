@@ -0,0 +1,53 @@
+#ifndef COLONNES
+#define COLONNES
+
+#include "../utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Batiment;
+
+// The building values the city totals are summed from, one contiguous
+// column each, one row per building of the city. Rows are packed: removing
+// a building moves the last row into its place. The sums run over the
+// columns with SIMD kernels picked at run time (AVX when the processor has
+// it, a scalar loop otherwise), long columns in fixed-size chunks across the
+// thread pool. Kernels and chunks always add in the same order, so a city
+// gives bit-identical totals on every machine and with any number of cores.
+class ColonnesBatiments {
+public:
+  // Appends a row with the consumption and pollution weight of batiment
+  uint32_t ajouter(Batiment *batiment);
+  // Removes a row and returns the building whose row took its place
+  // (nullptr when it was the last one), its row is now ligne
+  Batiment *retirer(uint32_t ligne);
+  size_t taille() const;
+
+  void setHabitants(uint32_t ligne, int nombre, int maximum);
+  void setRevenu(uint32_t ligne, double revenu, bool complet);
+  void setComplet(uint32_t ligne, bool complet); // staffing changed
+
+  Resources sommeConsommation() const;
+  double sommePollution() const;
+  double sommeOccupation() const; // habitants / (capacite + 1) per building
+  // Base income of the shops, those missing staff weighted by efficacite
+  double sommeRevenus(double efficacite) const;
+
+  // Kernels in use, the widest the processor runs unless some were forced
+  // (false when they are not available here); for checks and benchmarks
+  static const char *getJeuInstructions();
+  static bool choisirJeuInstructions(const char *nom);
+
+private:
+  std::vector<Batiment *> batiments;
+  std::vector<double> eau;
+  std::vector<double> electricite;
+  std::vector<double> pollution;
+  std::vector<double> habitants;
+  std::vector<double> capacite;
+  std::vector<double> revenusComplets; // shops with all their staff
+  std::vector<double> revenusPartiels; // shops missing staff
+};
+
+#endif // !COLONNES
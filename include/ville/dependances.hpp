@@ -0,0 +1,58 @@
+#ifndef DEPENDANCES
+#define DEPENDANCES
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+
+// Inputs the derived city values are computed from
+enum class Entree {
+  Batiments,    // a building was added or removed
+  Habitants,    // occupants of the residences
+  Population,   // city population
+  Emplois,      // staffing of the employers
+  Pollution,    // city-wide pollution
+  Satisfaction, // city-wide satisfaction
+  Ressources,   // water/electricity balance
+  Trafic,       // commute delays
+  Champ,        // per-tile pollution field
+};
+
+// Values recomputed at the end of a cycle
+enum class Derivee { Pollution, Satisfaction, Ressources, Population, Profit };
+
+// Skips the recomputation of a derived value while none of its inputs
+// changed. Every input carries a version bumped when it changes; a derived
+// value remembers the versions it was last computed from. A value that
+// writes one of its own inputs (population growth, or pollution overwriting
+// what an event set) is computed again on the next check, until it reaches
+// a fixed point.
+class SuiviDependances {
+public:
+  static constexpr int NOMBRE_ENTREES = 9;
+  static constexpr int NOMBRE_DERIVEES = 5;
+
+  void declarer(Derivee derivee, std::initializer_list<Entree> entrees);
+  void signaler(Entree entree); // entree changed, safe from any phase
+  // True when derivee has to be computed again, the caller then computes it
+  // from the inputs as they are now
+  bool aRecalculer(Derivee derivee);
+  // Off, every check answers true: what the values would be without the
+  // tracking, for checks
+  void setActif(bool actif);
+
+private:
+  struct Etat {
+    uint32_t entrees = 0; // bit per Entree
+    uint64_t signature = 0;
+    bool calculee = false;
+  };
+  std::array<std::atomic<uint64_t>, NOMBRE_ENTREES> versions{};
+  std::array<Etat, NOMBRE_DERIVEES> derivees;
+  bool actif = true;
+
+  uint64_t signature(uint32_t entrees) const;
+};
+
+#endif // !DEPENDANCES
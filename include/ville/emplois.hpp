@@ -0,0 +1,72 @@
+#ifndef EMPLOIS
+#define EMPLOIS
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class Service;
+
+// Workers split between the employers in proportion to their jobs. The
+// k-th position of an employer with n jobs weighs n / (k - 1/2) (Sainte-
+// Laguë), the heaviest positions are staffed and ties go to the employer
+// added first, so the split only depends on the employers and the
+// workforce. Unlike a largest-remainder split, one more worker or one more
+// employer only moves a few workers: two heaps keep the best open position
+// and the worst staffed one, workers move from one to the other while that
+// is an improvement.
+class RepartitionEmplois {
+public:
+  using Affectation = std::function<void(Service *, unsigned int)>;
+
+  void ajouter(Service *s); // starts with no share
+  void retirer(Service *s); // its share goes back to the others
+  // Staff min(travailleurs, jobs) positions; affecter is called for every
+  // employer whose staff differs from its share
+  void repartir(unsigned int travailleurs, const Affectation &affecter);
+  // The employers were staffed some other way, the next split starts over
+  void invalider();
+
+private:
+  static constexpr size_t AUCUN = SIZE_MAX;
+
+  struct Part {
+    Service *service;
+    unsigned int postes;   // jobs
+    unsigned int occupes;  // share of the workforce
+    uint64_t ordre;        // breaks ties, older first
+    size_t indexOuverts = AUCUN;
+    size_t indexPourvus = AUCUN;
+    size_t indexTouches = AUCUN;
+  };
+
+  // Parts are stored in the map nodes, which never move
+  std::unordered_map<const Service *, Part> parts;
+  std::vector<Part *> ouverts; // best next position on top
+  std::vector<Part *> pourvus; // worst staffed position on top
+  std::vector<Part *> touches; // share changed since the last split
+  unsigned long long places = 0; // staffed positions
+  unsigned long long postes = 0;
+  uint64_t prochainOrdre = 0;
+  size_t changements = 0; // employers added or removed since the last split
+  bool valide = true;
+
+  static bool mieux(const Part &a, unsigned int ka, const Part &b,
+                    unsigned int kb);
+  bool avant(const std::vector<Part *> &tas, size_t a, size_t b) const;
+  size_t &indexDans(const std::vector<Part *> &tas, Part *p) const;
+  void placer(std::vector<Part *> &tas, size_t i, Part *p);
+  void monter(std::vector<Part *> &tas, size_t i);
+  void descendre(std::vector<Part *> &tas, size_t i);
+  void inserer(std::vector<Part *> &tas, Part *p);
+  void enlever(std::vector<Part *> &tas, Part *p);
+  void actualiser(Part *p); // after its share changed
+  void toucher(Part *p);
+  void donner();
+  void prendre();
+  void reconstruire(unsigned long long cible);
+};
+
+#endif // !EMPLOIS
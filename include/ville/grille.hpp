@@ -0,0 +1,47 @@
+#ifndef GRILLE
+#define GRILLE
+
+#include "../utils.hpp"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Batiment;
+
+// Uniform bucket grid over tile coordinates, used for proximity queries
+// (k nearest employers) and to group buildings into regions
+class GrilleSpatiale {
+public:
+  explicit GrilleSpatiale(int tailleCellule = 8);
+
+  void inserer(Batiment *batiment);
+  void retirer(Batiment *batiment);
+  void vider();
+
+  // k nearest buildings within distanceMax (Manhattan, in tiles), sorted by
+  // distance then position so results do not depend on insertion order
+  void plusProches(Position origine, size_t k, int distanceMax,
+                   std::vector<std::pair<int, Batiment *>> &resultat) const;
+
+  // Every building whose position lies within distance tiles on both axes
+  void dansRayon(Position origine, int distance,
+                 std::vector<Batiment *> &resultat) const;
+
+  // Regions
+  long long cleCellule(Position position) const;
+  const std::vector<Batiment *> *cellule(long long cle) const;
+  std::vector<long long> cellulesVoisines(Position position,
+                                          int distance) const;
+  std::vector<long long> cellulesOccupees() const;
+
+  int getTailleCellule() const;
+
+private:
+  int tailleCellule;
+  std::unordered_map<long long, std::vector<Batiment *>> cellules;
+
+  int coordCellule(int tuile) const;
+  static long long cle(int cx, int cy);
+};
+
+#endif // !GRILLE
@@ -0,0 +1,38 @@
+#ifndef HANDLES
+#define HANDLES
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Batiment;
+
+// Building ids of a city. An id packs a slot index (low BITS_INDEX bits)
+// with the generation of that slot, bumped every time it is freed: live
+// ids never collide, a stale id never resolves to the building that took
+// its slot, and resolving an id is a single array access. A slot whose
+// generation is exhausted is retired rather than reused. 0 is never given.
+class TableHandles {
+public:
+  static constexpr int BITS_INDEX = 20;
+  static constexpr uint32_t NOMBRE_INDEX = 1u << BITS_INDEX;
+  static constexpr uint32_t GENERATION_MAX = (1u << (31 - BITS_INDEX)) - 1;
+
+  int allouer(Batiment *batiment); // 0 if every slot is taken
+  void liberer(int id);
+  Batiment *get(int id) const; // nullptr for a stale or unknown id
+  size_t getNombre() const;    // live ids
+
+  static uint32_t indexDe(int id);
+
+private:
+  struct Emplacement {
+    Batiment *batiment = nullptr;
+    uint32_t generation = 1;
+  };
+  std::vector<Emplacement> emplacements;
+  std::vector<uint32_t> libres;
+  size_t nombre = 0;
+};
+
+#endif // !HANDLES
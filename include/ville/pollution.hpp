@@ -0,0 +1,58 @@
+#ifndef POLLUTION
+#define POLLUTION
+
+#include "../utils.hpp"
+#include <vector>
+
+// Per-tile pollution. Buildings emit into the tiles they cover, pollution
+// spreads to the 4 neighbours and decays every step, parks absorb it.
+// The grid is stored row-major with a one tile border of zeros so the
+// stencil runs without bounds checks (pollution leaks out at the edges).
+class ChampPollution {
+public:
+  explicit ChampPollution(int largeur = 0, int hauteur = 0);
+
+  void redimensionner(int largeur, int hauteur);
+
+  // Sources and sinks, rebuilt whenever the city changes
+  void reinitialiserSources();
+  void ajouterSource(Position position, Surface surface, float emission);
+  void ajouterPuits(Position position, Surface surface, float absorption);
+
+  void etape();
+  bool simuler(int etapes); // false when the field had settled
+
+  float valeur(int x, int y) const;
+  float moyenne() const;
+  float moyenneSources() const; // at the emitting tiles, by emission
+  int getLargeur() const;
+  int getHauteur() const;
+
+  // Row kernel of the stencil, the widest the processor runs unless one was
+  // forced (false when it is not available here); for checks and benchmarks
+  static const char *getJeuInstructions();
+  static bool choisirJeuInstructions(const char *nom);
+
+  static float DIFFUSION;    // share sent to each neighbour per step (<0.25)
+  static float DECROISSANCE; // share that disappears per step
+
+private:
+  int largeur;
+  int hauteur;
+  int pas; // row stride including the border, rounded up to 8 floats
+
+  std::vector<float> courant;
+  std::vector<float> suivant;
+  std::vector<float> emission;     // added every step
+  std::vector<float> retenue;      // kept by the sinks every step
+  std::vector<float> conservation; // kept every step (decay and sinks)
+  float decroissance = 0.0f;       // DECROISSANCE conservation was built with
+  bool stable = false;             // the last step changed nothing
+  float diffusionStable = 0.0f;    // DIFFUSION when it settled
+
+  size_t index(int x, int y) const;
+  void etapeLigne(int y, float diffusion);
+  void calculerConservation();
+};
+
+#endif // !POLLUTION
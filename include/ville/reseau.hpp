@@ -0,0 +1,62 @@
+#ifndef RESEAU
+#define RESEAU
+
+#include "../utils.hpp"
+#include "grille.hpp"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Infrastructure;
+
+// Water/electricity network. Buildings whose footprints are at most
+// PORTEE tiles apart are connected; plants feed their connected component,
+// closest consumers (in hops) first, so shortages stay local to the
+// components and the far ends of the lines that lack production.
+class ReseauRessources {
+public:
+  static constexpr int PORTEE = 3;
+
+  void ajouter(Batiment *batiment);
+  void retirer(Batiment *batiment);
+
+  // Serve every consumer for one cycle; returns what was delivered
+  Resources distribuer();
+
+  Resources getProductionTotale() const;
+  Resources getDemandeTotale() const;
+  Resources getPenurieTotale() const;
+  Resources getPenurie(const Batiment *batiment) const;
+
+private:
+  struct Noeud {
+    std::vector<Batiment *> voisins;
+    int composante = -1;
+    size_t rang = 0;      // position in the component's serving order
+    bool nouveau = true;  // waits in nouveaux for its first component
+  };
+
+  struct Composante {
+    std::vector<Batiment *> ordre; // plants first, then by hops from them
+    std::vector<Infrastructure *> centrales;
+    std::vector<Resources> penuries; // aligned with ordre
+  };
+
+  GrilleSpatiale grille;
+  std::unordered_map<Batiment *, Noeud> noeuds;
+  std::unordered_map<int, Composante> composantes;
+  std::unordered_set<int> composantesModifiees;
+  std::vector<Batiment *> nouveaux; // may hold removed buildings
+  int prochaineComposante = 0;
+
+  Resources production;
+  Resources demande;
+  Resources penurie;
+
+  static bool estCentrale(const Batiment &batiment);
+  static bool raccordes(const Batiment &a, const Batiment &b);
+  void reconstruire();
+  void ordonner(Composante &composante, const std::vector<Batiment *> &membres);
+};
+
+#endif // !RESEAU
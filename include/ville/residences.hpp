@@ -0,0 +1,52 @@
+#ifndef RESIDENCES
+#define RESIDENCES
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+class Resident;
+
+// How new residents are spread over the available housing
+enum class PolitiqueRemplissage {
+  Compacte, // fill the fullest residences first, empty the emptiest first
+  Repartie  // one resident at a time into the emptiest residence
+};
+
+// Residences bucketed by free capacity and by occupants, so finding where
+// to place or remove someone is O(1) instead of a scan over the city
+class IndexResidences {
+public:
+  void ajouter(Resident *r);
+  void retirer(Resident *r);
+  void actualiser(Resident *r); // after its occupants changed
+
+  // Next residence with room (nullptr when the city is full)
+  Resident *prochaineLibre(PolitiqueRemplissage politique) const;
+  // Next residence to take people out of (nullptr when nobody lives here)
+  Resident *prochaineOccupee(PolitiqueRemplissage politique) const;
+
+  const std::vector<Resident *> &toutes() const;
+  size_t taille() const;
+
+private:
+  struct Place {
+    size_t indexToutes;
+    int libre;
+    size_t indexLibre;
+    int occupants;
+    size_t indexOccupants;
+  };
+
+  std::vector<Resident *> residences;
+  std::vector<std::vector<Resident *>> parLibre;     // [free slots]
+  std::vector<std::vector<Resident *>> parOccupants; // [occupants]
+  std::unordered_map<const Resident *, Place> places;
+
+  static void inserer(std::vector<std::vector<Resident *>> &seaux, int seau,
+                      Resident *r, size_t &index);
+  void enlever(std::vector<std::vector<Resident *>> &seaux, int seau,
+               size_t index, bool libre);
+};
+
+#endif // !RESIDENCES
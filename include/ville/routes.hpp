@@ -0,0 +1,95 @@
+#ifndef ROUTES
+#define ROUTES
+
+#include "../utils.hpp"
+#include <array>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Road tiles and the pathfinding service built on them. Queries use a
+// hierarchical A* (HPA*): the map is cut into TAILLE_CHUNK square chunks,
+// every run of road crossing a chunk border becomes an entrance, and the
+// entrances of a chunk are linked by their in-chunk distances. A query
+// searches that small abstract graph instead of the tiles, paths are
+// refined chunk by chunk only when they are actually requested.
+// Editing a road only rebuilds the chunks around it.
+// Distances are those of the best path through the entrances: never
+// shorter than the road distance, and longer by at most twice the way to
+// the nearest entrance of the border run (14 tiles) at each chunk border
+// the shortest road path crosses. test/verif_routes.cpp checks both.
+class ReseauRoutier {
+public:
+  static constexpr int TAILLE_CHUNK = 16;
+
+  explicit ReseauRoutier(int largeur = 0, int hauteur = 0);
+
+  bool ajouterRoute(Position position);
+  bool retirerRoute(Position position);
+  bool estRoute(int x, int y) const;
+  size_t getNombreRoutes() const;
+  unsigned long getRevision() const;
+
+  // Rebuilds the modified chunks. Must run before concurrent queries, the
+  // const queries below are then safe to call from several threads.
+  void preparer();
+
+  // Length in tiles of the road path between two road tiles, -1 if none
+  int distance(Position depart, Position arrivee) const;
+  bool chemin(Position depart, Position arrivee,
+              std::vector<Position> &resultat) const;
+
+  // Answers every query across the worker threads
+  void distances(std::span<const std::pair<Position, Position>> requetes,
+                 std::vector<int> &resultats);
+
+private:
+  struct Arete {
+    int tuile;
+    int cout;
+  };
+
+  int largeur;
+  int hauteur;
+  int chunksX;
+  int chunksY;
+  unsigned long revision = 0;
+  size_t nombreRoutes = 0;
+
+  std::vector<unsigned char> routes;
+  // Entrances as (tile, tile) pairs across the border between chunk i and
+  // its right (bordsH) or lower (bordsV) neighbour
+  std::vector<std::vector<std::pair<int, int>>> bordsH;
+  std::vector<std::vector<std::pair<int, int>>> bordsV;
+  std::vector<int> references; // how many entrances use each tile
+  std::vector<std::vector<int>> noeuds; // entrance tiles of each chunk
+  std::vector<std::vector<Arete>> aretes; // abstract edges of each tile
+  std::vector<unsigned char> chunksModifies;
+  bool modifie = false;
+
+  // Distances already answered, dropped when the roads change
+  static constexpr size_t NOMBRE_TRANCHES = 16;
+  static constexpr size_t TAILLE_MAX_TRANCHE = 1 << 14;
+  struct Tranche {
+    std::mutex verrou;
+    std::unordered_map<unsigned long long, int> distances;
+  };
+  mutable std::array<Tranche, NOMBRE_TRANCHES> cache;
+
+  bool dansCarte(int x, int y) const;
+  int tuile(int x, int y) const;
+  int chunkDe(int tuile) const;
+  void marquerModifie(Position position);
+  void calculerBord(std::vector<std::pair<int, int>> &bord, int chunk,
+                    bool horizontal);
+  void relierChunk(int chunk);
+  void explorerChunk(int depart, std::vector<int> &distances) const;
+  int rechercher(int depart, int arrivee, std::vector<int> *parcours) const;
+  bool cheminLocal(int depart, int arrivee,
+                   std::vector<Position> &resultat) const;
+  void viderCache();
+};
+
+#endif // !ROUTES
@@ -0,0 +1,61 @@
+#ifndef TRAFIC
+#define TRAFIC
+
+#include "../utils.hpp"
+#include <cstdint>
+#include <vector>
+
+// Morning commute played out by individual agents on the road tiles.
+// Agents are stored as parallel arrays (one entry per agent in each) and
+// only refer to a shared path, so a million of them stay cheap. Every step
+// each travelling agent tries to enter the next tile of its path; a tile
+// asked for by more than CAPACITE_ROUTE agents lets roughly that many in
+// and the others wait. Departures are spread over a rush hour window.
+// Agents still out after PAS_MAX steps count the delay they have so far.
+class TraficAgents {
+public:
+  static constexpr uint32_t CAPACITE_ROUTE = 12; // agents entering a tile per step
+  static constexpr uint16_t FENETRE_DEPART = 16; // steps over which agents leave
+  static constexpr uint16_t PAS_MAX = 256;       // agents still out are cut off
+
+  explicit TraficAgents(int largeur = 0, int hauteur = 0);
+
+  void vider();
+  // nombre agents of the same group follow chemin (consecutive road tiles)
+  void ajouterTrajet(const std::vector<Position> &chemin, uint32_t nombre,
+                     uint32_t groupe);
+
+  // Plays one commute and refreshes the statistics below
+  void simuler();
+
+  size_t getNombreAgents() const;
+  uint32_t getCharge(int x, int y) const; // agents that entered the tile
+  float getRetardMoyen() const;           // extra steps per agent
+  float getRetardRelatif() const;         // extra time over free-flow time
+  float getRetardGroupe(uint32_t groupe) const;
+
+private:
+  int largeur;
+  int hauteur;
+
+  // Paths, stored back to back
+  std::vector<int> tuilesChemins;
+  std::vector<uint32_t> debutsChemins{0};
+
+  // Agents
+  std::vector<uint32_t> cheminAgent;
+  std::vector<uint32_t> groupeAgent;
+  std::vector<uint16_t> departAgent;
+  std::vector<uint16_t> etapeAgent;   // index of the current tile in the path
+  std::vector<uint16_t> arriveeAgent; // step of arrival
+
+  // Results of the last commute
+  std::vector<uint32_t> charge;
+  std::vector<uint32_t> demande;
+  std::vector<double> retardGroupes;
+  std::vector<uint32_t> agentsGroupes;
+  double retardTotal = 0.0;
+  double tempsLibreTotal = 0.0;
+};
+
+#endif // !TRAFIC
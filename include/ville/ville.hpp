@@ -2,16 +2,35 @@
 #define VILLE
 
 #include "../utils.hpp"
+#include "agrements.hpp"
+#include "colonnes.hpp"
+#include "dependances.hpp"
+#include "emplois.hpp"
+#include "grille.hpp"
+#include "handles.hpp"
+#include "pollution.hpp"
+#include "reseau.hpp"
+#include "residences.hpp"
+#include "routes.hpp"
+#include "trafic.hpp"
+#include <array>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 
+class AreneBatiments;
 class Batiment;
+class Resident;
+class Service;
 
 class Ville {
 public:
   Ville(const string &nom, double budget, unsigned int population,
-        Resources resources, BatimentList batiments);
+        Resources resources, BatimentList batiments, int largeurCarte = 64,
+        int hauteurCarte = 64);
   ~Ville();
 
   Ville(const Ville &) = delete;
@@ -19,25 +38,66 @@ public:
 
   // Enable move
   Ville(Ville &&) = default;
-  Ville &operator=(Ville &&) = default;
+  // Assigning would release the old arena before the buildings it holds
+  Ville &operator=(Ville &&) = delete;
 
   void ajoutBatiment(BatPtr batiment);
+  void ajoutBatiments(std::span<BatPtr> nouveaux); // one recomputation
   void supprimerBatiment(int x, int y);
+  // Batch edits: derived state (jobs, revision) is only recomputed once the
+  // outermost finModifications() is reached
+  void debutModifications();
+  void finModifications();
   Resources calculerconsommationTotale();
   Resources calculerResourcesTotale();
+  void distribuerRessources(); // serve consumers through the utility network
+  Resources getPenurie(const Batiment *batiment) const;
+  Resources getPenurieTotale() const;
+  // City-wide pollution, from what the per-tile field brings to the homes
   float calculerPolutionTotale();
+  void diffuserPollution(); // advance the per-tile pollution field
   int calculerSatisfactionTotale();
+  float calculerBonusAgrements(); // amenities around where people live
+  float getCouvertureAgrement(Agrement agrement, int x, int y) const;
   // Employment
   unsigned int calculerCapaciteEmploi() const;
   unsigned int calculerEmploiActuel() const;
   float calculerTauxChomage() const;
   void assignerEmplois(); // Distribute population to jobs
+  // Commute model: residents only take jobs within distanceMax tiles, the
+  // nearest employers first. Roads shorten commutes between buildings that
+  // both touch the network.
+  void setModeTrajet(bool actif);
+  bool getModeTrajet() const;
+  void setParametresTrajet(int distanceMax, size_t employeursParResidence);
   void afficherStatutEmploi() const; // Display job status per building
   int calculerPopulationTotale() const;
   int calculerCapacitePopulation() const;
   double calculerProfit();
+  // Share of the shops' income left by pollution, as of the last profit
+  double getFacteurProfit() const;
   void collectProfit();
   void updatePopulation();
+  void setPolitiqueRemplissage(PolitiqueRemplissage politique);
+  PolitiqueRemplissage getPolitiqueRemplissage() const;
+  // Off, the end of cycle values are computed again every time even when
+  // none of their inputs changed; for checks
+  void setSuiviDependances(bool actif);
+
+  // Roads, refused on tiles covered by a building
+  bool ajouterRoute(int x, int y);
+  bool retirerRoute(int x, int y);
+  bool estRoute(int x, int y) const;
+  ReseauRoutier &getRoutes();
+  const ReseauRoutier &getRoutes() const;
+
+  // Traffic: commuters from the commute model drive to work on the roads,
+  // congestion lowers satisfaction. Turning it on enables the commute model.
+  void setTrafic(bool actif);
+  bool getTrafic() const;
+  void simulerTrafic();
+  const TraficAgents &getAgentsTrafic() const;
+  float getRetardTrafic(const Batiment *residence) const;
 
   // Getters
   string getNom() const;
@@ -47,6 +107,14 @@ public:
   float getPolution() const;
   Resources getResources() const;
   Batiment* getBatimentByPos(int x, int y) const;
+  Batiment* getBatimentById(int id) const; // nullptr once it was removed
+  unsigned long getRevision() const; // bumped after each committed edit
+  unsigned int getNombreBatiments(TypeBatiment type) const;
+  unsigned long getBatimentsAjoutes() const; // since the city was created
+  unsigned long getBatimentsRetires() const;
+  float getPollutionTuile(int x, int y) const;
+  const ChampPollution &getChampPollution() const;
+  ChampPollution &getChampPollution();
 
   // Setters
   void setBudget(double newBudget);
@@ -56,7 +124,14 @@ public:
   void setResources(Resources newResources);
 
 
+private:
+  // Declared before batiments so it is destroyed after them
+  std::unique_ptr<AreneBatiments> arene;
+
+public:
   BatimentList batiments;
+  AreneBatiments &getArene(); // where the factories allocate for this city
+
 private:
   string nom;
   double budget;
@@ -64,6 +139,110 @@ private:
   int satisfaction;
   float polution;
   Resources resources;
+
+  // Incremental job market: totals are kept up to date on every mutation so
+  // assignerEmplois only touches what changed since the last assignment
+  std::vector<Service *> employeurs;
+  RepartitionEmplois repartition; // proportional split, outside commute mode
+  unsigned int capaciteEmploi = 0;
+  unsigned int emploiActuel = 0;
+  int populationLogee = 0;
+  int capaciteLogement = 0;
+  unsigned int travailleursAssignes = 0; // workers used by last matching
+  bool emploisModifies = true;           // commute matching required
+
+  // Values the city totals are summed from
+  ColonnesBatiments colonnes;
+  // End of cycle values are only recomputed when what they read changed
+  SuiviDependances dependances;
+  double profit = 0.0;        // shop income, as of the last calculerProfit
+  double facteurProfit = 1.0; // pollution factor it was computed with
+  float efficaciteProfit = 0.0f;
+  float penaliteProfit = 0.0f;
+
+  // Per-tile pollution
+  ChampPollution champPollution;
+  unsigned long revisionSourcesPollution = 0;
+  bool sourcesPollutionValides = false;
+
+  // Utility network
+  ReseauRessources reseau;
+
+  // Roads
+  ReseauRoutier routes;
+  static constexpr int VITESSE_ROUTE = 2; // tiles per commute unit on roads
+
+  // Traffic
+  struct Flux {
+    Resident *residence;
+    Service *employeur;
+    unsigned int travailleurs;
+    bool operator==(const Flux &) const = default;
+  };
+  std::vector<Flux> fluxTrajet; // filled by the commute matching
+  unsigned long revisionFlux = 0;
+  bool traficActif = false;
+  TraficAgents trafic;
+  std::unordered_map<const Batiment *, uint32_t> groupesTrafic;
+  unsigned long revisionFluxTrafic = 0;
+  unsigned long revisionRoutesTrafic = 0;
+
+  // Amenity coverage
+  mutable CarteAgrements agrements; // refreshed lazily on read
+
+  // Housing
+  IndexResidences residences;
+  PolitiqueRemplissage politiqueRemplissage = PolitiqueRemplissage::Compacte;
+
+  // Batch edits
+  unsigned int modificationsEnCours = 0;
+  bool modificationsEnAttente = false;
+  unsigned long revision = 0;
+  std::array<unsigned int, NOMBRE_TYPES_BATIMENT> batimentsParType{};
+  unsigned long batimentsAjoutes = 0;
+  unsigned long batimentsRetires = 0;
+  TableHandles handles;
+
+  // Commute-based job matching
+  bool modeTrajet = false;
+  int distanceTrajetMax = 20;
+  size_t employeursParResidence = 8;
+  GrilleSpatiale grilleEmployeurs;
+  GrilleSpatiale grilleResidences;
+  std::unordered_set<long long> regionsModifiees; // residence cells to redo
+  std::unordered_map<const Batiment *, std::vector<std::pair<int, Batiment *>>>
+      candidatsTrajet;
+  // Flows of each residence, kept from one matching to the next
+  std::unordered_map<const Batiment *, std::vector<Flux>> fluxParResidence;
+  std::unordered_set<Resident *> residencesARapparier;
+  std::unordered_set<Service *> employeursLiberes; // lost commuters
+  bool trajetsAReconstruire = true; // match every residence from scratch
+  bool fluxRetires = false; // flows dropped by a removal since the last run
+
+  static bool estEmployeur(const Batiment &batiment);
+  static bool estResidence(const Batiment &batiment);
+  static bool agrementDe(const Batiment &batiment, Agrement &agrement);
+  void indexerBatiment(Batiment *batiment);
+  void desindexerBatiment(Batiment *batiment);
+  void affecterEmployes(Service *s, unsigned int count);
+  void modifierHabitants(Resident *r, int delta);
+  int logerHabitants(int nombre);
+  int retirerHabitants(int nombre);
+  void modificationEffectuee();
+  void placerSourcesPollution();
+  float calculerExpositionPollution() const;
+  void invaliderTrajets(Position position);
+  void actualiserCandidatsTrajet();
+  void assignerEmploisParTrajet();
+  bool apparierTrajets(const std::vector<Resident *> &logements,
+                       std::unordered_map<Service *, unsigned int> &effectifs);
+  void reconstruireTrajets();
+  void routesModifiees();
+  void construireTrafic();
+  bool accesRoute(const Batiment &batiment, Position &acces) const;
+  int coutTrajet(const Batiment &depart, const Batiment &arrivee,
+                 int marche) const;
+  void appliquerModifications();
 };
 
 #endif // !VILLE
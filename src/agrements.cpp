@@ -0,0 +1,127 @@
+#include "../include/ville/agrements.hpp"
+#include <algorithm>
+
+CarteAgrements::CarteAgrements(int largeur, int hauteur) {
+  redimensionner(largeur, hauteur);
+}
+
+void CarteAgrements::redimensionner(int largeur, int hauteur) {
+  this->largeur = std::max(0, largeur);
+  this->hauteur = std::max(0, hauteur);
+  size_t taille = static_cast<size_t>(this->largeur) * this->hauteur;
+  for (auto &couche : couches) {
+    couche.sources.assign(taille, 0.0f);
+    couche.horizontale.assign(taille, 0.0f);
+    couche.couverture.assign(taille, 0.0f);
+    couche.modifiee = Zone{};
+  }
+}
+
+void CarteAgrements::ajouter(Agrement agrement, Position position,
+                             Surface surface) {
+  deposer(agrement, position, surface, 1.0f);
+}
+
+void CarteAgrements::retirer(Agrement agrement, Position position,
+                             Surface surface) {
+  deposer(agrement, position, surface, -1.0f);
+}
+
+// A building counts once, spread over the tiles it covers (longeur along x,
+// largeur along y)
+void CarteAgrements::deposer(Agrement agrement, Position position,
+                             Surface surface, float poids) {
+  Couche &couche = couches[static_cast<int>(agrement)];
+  int longeur = std::max(1, static_cast<int>(surface.longeur));
+  int larg = std::max(1, static_cast<int>(surface.largeur));
+  float parTuile = poids / static_cast<float>(longeur * larg);
+
+  int x0 = std::max(0, position.x), y0 = std::max(0, position.y);
+  int x1 = std::min(largeur - 1, position.x + longeur - 1);
+  int y1 = std::min(hauteur - 1, position.y + larg - 1);
+  if (x1 < x0 || y1 < y0)
+    return;
+
+  for (int y = y0; y <= y1; ++y)
+    for (int x = x0; x <= x1; ++x)
+      couche.sources[static_cast<size_t>(y) * largeur + x] += parTuile;
+
+  Zone &zone = couche.modifiee;
+  if (zone.vide()) {
+    zone = {x0, y0, x1, y1};
+  } else {
+    zone.x0 = std::min(zone.x0, x0);
+    zone.y0 = std::min(zone.y0, y0);
+    zone.x1 = std::max(zone.x1, x1);
+    zone.y1 = std::max(zone.y1, y1);
+  }
+}
+
+void CarteAgrements::actualiser() {
+  for (int i = 0; i < NOMBRE; ++i)
+    if (!couches[i].modifiee.vide())
+      actualiserCouche(couches[i], RAYONS[i]);
+}
+
+void CarteAgrements::actualiserCouche(Couche &couche, int rayon) {
+  const Zone zone = couche.modifiee;
+  couche.modifiee = Zone{};
+
+  // Horizontal sums change on the modified rows, rayon tiles around them
+  int hx0 = std::max(0, zone.x0 - rayon);
+  int hx1 = std::min(largeur - 1, zone.x1 + rayon);
+  for (int y = zone.y0; y <= zone.y1; ++y) {
+    const float *src = couche.sources.data() + static_cast<size_t>(y) * largeur;
+    float *dst = couche.horizontale.data() + static_cast<size_t>(y) * largeur;
+    float somme = 0.0f;
+    for (int x = std::max(0, hx0 - rayon); x <= std::min(largeur - 1, hx0 + rayon);
+         ++x)
+      somme += src[x];
+    for (int x = hx0; x <= hx1; ++x) {
+      dst[x] = somme;
+      if (x + rayon + 1 < largeur)
+        somme += src[x + rayon + 1];
+      if (x - rayon >= 0)
+        somme -= src[x - rayon];
+    }
+  }
+
+  // Vertical sums over the same columns, rayon rows further each way. The
+  // running sum is kept per column so the inner loops stay contiguous
+  int vy0 = std::max(0, zone.y0 - rayon);
+  int vy1 = std::min(hauteur - 1, zone.y1 + rayon);
+  int colonnes = hx1 - hx0 + 1;
+  std::vector<float> sommes(colonnes, 0.0f);
+  for (int y = std::max(0, vy0 - rayon); y <= std::min(hauteur - 1, vy0 + rayon);
+       ++y) {
+    const float *h =
+        couche.horizontale.data() + static_cast<size_t>(y) * largeur + hx0;
+    for (int i = 0; i < colonnes; ++i)
+      sommes[i] += h[i];
+  }
+  for (int y = vy0; y <= vy1; ++y) {
+    float *dst =
+        couche.couverture.data() + static_cast<size_t>(y) * largeur + hx0;
+    for (int i = 0; i < colonnes; ++i)
+      dst[i] = std::max(0.0f, sommes[i]);
+    if (y + rayon + 1 < hauteur) {
+      const float *entre = couche.horizontale.data() +
+                           static_cast<size_t>(y + rayon + 1) * largeur + hx0;
+      for (int i = 0; i < colonnes; ++i)
+        sommes[i] += entre[i];
+    }
+    if (y - rayon >= 0) {
+      const float *sort = couche.horizontale.data() +
+                          static_cast<size_t>(y - rayon) * largeur + hx0;
+      for (int i = 0; i < colonnes; ++i)
+        sommes[i] -= sort[i];
+    }
+  }
+}
+
+float CarteAgrements::couverture(Agrement agrement, int x, int y) const {
+  if (x < 0 || x >= largeur || y < 0 || y >= hauteur)
+    return 0.0f;
+  return couches[static_cast<int>(agrement)]
+      .couverture[static_cast<size_t>(y) * largeur + x];
+}
@@ -3,11 +3,16 @@
 #include "../include/buildings/commercial.hpp"
 #include "../include/buildings/parc.hpp"
 #include "../include/buildings/resident.hpp"
+#include "../include/buildings/traits.hpp"
 #include "../include/cycle/simulation.hpp"
 #include "../tools/imgui/imgui.h"
 #include "../tools/imgui/imgui_impl_sdl2.h"
 #include "../tools/imgui/imgui_impl_sdlrenderer2.h"
 #include <SDL2/SDL_events.h>
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
 
@@ -47,6 +52,7 @@ Application::Application(const WindowSettings &settings)
 }
 
 Application::~Application() {
+  stopSimulation();
   ImGui_ImplSDLRenderer2_Shutdown();
   ImGui_ImplSDL2_Shutdown();
   ImGui::DestroyContext();
@@ -55,6 +61,161 @@ Application::~Application() {
 
 void Application::stop() { running = false; }
 
+void placeBuildingsOnTilemap(int tilemap[][64], int rows, int cols,
+                             int tileCount,
+                             const std::vector<BatPtr> &buildings);
+
+// Fixed timestep: elapsed time is accumulated in performance counter ticks
+// and consumed by whole steps, so the cycle timer follows the wall clock
+// whatever the frame rate or how late the thread wakes up.
+void Application::simulationLoop() {
+  const Uint64 frequence = SDL_GetPerformanceFrequency();
+  const Uint64 pas = static_cast<Uint64>(frequence * SIM_STEP);
+  Uint64 precedent = SDL_GetPerformanceCounter();
+  Uint64 accumulateur = 0;
+  while (simulationRunning) {
+    Uint64 maintenant = SDL_GetPerformanceCounter();
+    accumulateur += maintenant - precedent;
+    precedent = maintenant;
+    accumulateur = std::min(accumulateur, pas * MAX_CATCH_UP_STEPS);
+    {
+      std::lock_guard<std::mutex> verrou(verrouSimulation);
+      Commande commande;
+      bool edite = false;
+      while (commandes.extraire(commande)) {
+        appliquerCommande(commande);
+        edite = true;
+      }
+      if (edite)
+        sim.publierStats();
+      dureeDernierPas = 0.0;
+      while (accumulateur >= pas) {
+        Uint64 debut = SDL_GetPerformanceCounter();
+        sim.tick(static_cast<float>(SIM_STEP));
+        dureeDernierPas = std::max(
+            dureeDernierPas,
+            (SDL_GetPerformanceCounter() - debut) * 1000.0 / frequence);
+        accumulateur -= pas;
+      }
+      publierInstantane(maintenant - accumulateur);
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(
+        (pas - accumulateur) * 1000000000ull / frequence));
+  }
+}
+
+void Application::stopSimulation() {
+  simulationRunning = false;
+  if (simulationThread.joinable())
+    simulationThread.join();
+}
+
+// A full queue only delays the edit: it waits for the simulation to catch
+// up instead of being dropped, behind any command already waiting
+void Application::envoyerCommande(const Commande &commande) {
+  if (!commandesEnAttente.empty() || !commandes.pousser(commande))
+    commandesEnAttente.push_back(commande);
+}
+
+void Application::envoyerCommandesEnAttente() {
+  while (!commandesEnAttente.empty() &&
+         commandes.pousser(commandesEnAttente.front()))
+    commandesEnAttente.pop_front();
+}
+
+void Application::appliquerCommande(const Commande &commande) {
+  Ville &ville = sim.getVille();
+  switch (commande.type) {
+  case Commande::Type::Detruire:
+    if (Batiment *bat = ville.getBatimentByPos(commande.x, commande.y))
+      ville.supprimerBatiment(bat->position.x, bat->position.y);
+    else
+      ville.retirerRoute(commande.x, commande.y);
+    break;
+  case Commande::Type::AjouterRoute:
+    ville.ajouterRoute(commande.x, commande.y);
+    break;
+  case Commande::Type::TerminerCycle:
+    sim.terminerCycleEarly();
+    break;
+  case Commande::Type::ModeTrajet:
+    ville.setModeTrajet(commande.actif);
+    ville.assignerEmplois();
+    break;
+  case Commande::Type::Trafic:
+    ville.setTrafic(commande.actif);
+    ville.assignerEmplois();
+    break;
+  case Commande::Type::Repartie:
+    ville.setPolitiqueRemplissage(commande.actif
+                                      ? PolitiqueRemplissage::Repartie
+                                      : PolitiqueRemplissage::Compacte);
+    break;
+  case Commande::Type::CycleParallele:
+    sim.setCycleParallele(commande.actif);
+    break;
+  }
+}
+
+// Called with verrouSimulation held. The map layers are only rebuilt when
+// the city changed, otherwise the previous snapshot's are shared.
+// horodatage is the performance counter value the simulation state is at.
+void Application::publierInstantane(Uint64 horodatage) {
+  const Ville &ville = sim.getVille();
+  auto instantane = std::make_shared<Instantane>();
+  instantane->stats = sim.getStats();
+  instantane->historique = sim.partagerHistorique();
+  instantane->tempsCycle = sim.getCurrentTime();
+  instantane->dureeCycle = sim.getTimePerCycle();
+  instantane->enCours = sim.getState() == SimState::Running;
+  instantane->dureePas = dureeDernierPas;
+  instantane->dureesPhases = sim.getDureesPhases();
+  instantane->horodatage =
+      static_cast<double>(horodatage) / SDL_GetPerformanceFrequency();
+  instantane->modeTrajet = ville.getModeTrajet();
+  instantane->trafic = ville.getTrafic();
+  instantane->repartie =
+      ville.getPolitiqueRemplissage() == PolitiqueRemplissage::Repartie;
+  instantane->cycleParallele = sim.getCycleParallele();
+  instantane->largeur = MAP_COLS;
+  instantane->hauteur = MAP_ROWS;
+  instantane->revision = ville.getRevision();
+
+  if (dernierInstantane &&
+      dernierInstantane->revision == instantane->revision) {
+    instantane->revisionPrecedente = dernierInstantane->revisionPrecedente;
+    instantane->tuiles = dernierInstantane->tuiles;
+    instantane->routes = dernierInstantane->routes;
+    instantane->tuilesModifiees = dernierInstantane->tuilesModifiees;
+  } else {
+    int batimentsTuiles[MAP_ROWS][MAP_COLS];
+    int *debut = &batimentsTuiles[0][0];
+    std::fill(debut, debut + MAP_ROWS * MAP_COLS, -1);
+    placeBuildingsOnTilemap(batimentsTuiles, MAP_ROWS, MAP_COLS, TILE_COUNT,
+                            ville.batiments);
+    auto tuiles = std::make_shared<std::vector<int>>(
+        debut, debut + MAP_ROWS * MAP_COLS);
+    auto routes = std::make_shared<std::vector<unsigned char>>(
+        MAP_ROWS * MAP_COLS);
+    for (int y = 0; y < MAP_ROWS; ++y)
+      for (int x = 0; x < MAP_COLS; ++x)
+        (*routes)[y * MAP_COLS + x] = ville.estRoute(x, y);
+
+    if (dernierInstantane) {
+      instantane->revisionPrecedente = dernierInstantane->revision;
+      for (int i = 0; i < MAP_ROWS * MAP_COLS; ++i)
+        if ((*tuiles)[i] != (*dernierInstantane->tuiles)[i] ||
+            (*routes)[i] != (*dernierInstantane->routes)[i])
+          instantane->tuilesModifiees.push_back(i);
+    }
+    instantane->tuiles = std::move(tuiles);
+    instantane->routes = std::move(routes);
+  }
+
+  dernierInstantane = instantane;
+  instantanes.publier(std::move(instantane));
+}
+
 void Application::displayInspect(ImGuiWindowFlags flags, float x, float y,
                                  int value, bool isHoveringRect, float speed,
                                  float recwidth) const {
@@ -70,11 +231,22 @@ void Application::displayInspect(ImGuiWindowFlags flags, float x, float y,
 
   ImGui::Begin("Inspector", nullptr, flags);
 
-  if (isHoveringRect) {
+  // Live city data, skipped while the simulation thread is busy with it
+  std::unique_lock<std::mutex> verrou(verrouSimulation, std::try_to_lock);
+  if (!verrou.owns_lock()) {
+    ImGui::Text("Simulating...");
+  } else if (isHoveringRect) {
     Batiment *batiment = sim.getVille().getBatimentByPos(static_cast<int>(x),
                                                          static_cast<int>(y));
     if (batiment) {
       batiment->afficheDetails();
+      Resources manque = sim.getVille().getPenurie(batiment);
+      if (manque.eau > 0.0 || manque.electricite > 0.0)
+        ImGui::Text("Shortage: %.1f water, %.1f electricity", manque.eau,
+                    manque.electricite);
+      if (sim.getVille().getTrafic())
+        ImGui::Text("Commute delay: %.1f",
+                    sim.getVille().getRetardTrafic(batiment));
     } else {
       ImGui::Text("No building at this tile");
     }
@@ -84,6 +256,22 @@ void Application::displayInspect(ImGuiWindowFlags flags, float x, float y,
     if (ImGui::CollapsingHeader("World Info", ImGuiTreeNodeFlags_DefaultOpen)) {
       ImGui::Text("Tile coords: (%.1f, %.1f)", x, y);
       ImGui::Text("Tile value: %d", value);
+      ImGui::Text("Tile pollution: %.2f",
+                  sim.getVille().getPollutionTuile(static_cast<int>(x),
+                                                   static_cast<int>(y)));
+      ImGui::Text("Parks / shops / utilities nearby: %.1f / %.1f / %.1f",
+                  sim.getVille().getCouvertureAgrement(
+                      Agrement::Parc, static_cast<int>(x), static_cast<int>(y)),
+                  sim.getVille().getCouvertureAgrement(
+                      Agrement::Commerce, static_cast<int>(x),
+                      static_cast<int>(y)),
+                  sim.getVille().getCouvertureAgrement(
+                      Agrement::Service, static_cast<int>(x),
+                      static_cast<int>(y)));
+      if (sim.getVille().estRoute(static_cast<int>(x), static_cast<int>(y)))
+        ImGui::Text("Commuters: %u",
+                    sim.getVille().getAgentsTrafic().getCharge(
+                        static_cast<int>(x), static_cast<int>(y)));
       ImGui::Text("Rectangle width: %.1f", recwidth);
     }
 
@@ -94,7 +282,8 @@ void Application::displayInspect(ImGuiWindowFlags flags, float x, float y,
   ImGui::End();
 }
 
-void Application::displayTaskBar(ImGuiWindowFlags flags, Simulation &sim) {
+void Application::displayTaskBar(ImGuiWindowFlags flags,
+                                 const Instantane &etat, float tempsCycle) {
   ImGuiViewport *viewport = ImGui::GetMainViewport();
   ImGui::SetNextWindowPos(ImVec2(
       viewport->Pos.x, viewport->Pos.y + viewport->Size.y - taskbarHeight));
@@ -102,33 +291,33 @@ void Application::displayTaskBar(ImGuiWindowFlags flags, Simulation &sim) {
 
   ImGui::Begin("Taskbar", nullptr, flags | ImGuiWindowFlags_NoTitleBar);
 
-  ImGui::Text("%s :", sim.getVille().getNom().c_str());
+  const CityStats &stats = *etat.stats;
+  ImGui::Text("%s :", stats.nom.c_str());
   ImGui::SameLine();
-  ImGui::Text("Population: %d", sim.getVille().getPopulation());
+  ImGui::Text("Population: %d", stats.population);
   ImGui::SameLine();
-  ImGui::Text("Employed: %d / %d", sim.getVille().calculerEmploiActuel(),
-              sim.getVille().calculerCapaciteEmploi());
+  ImGui::Text("Employed: %d / %d", stats.emploiActuel, stats.capaciteEmploi);
   ImGui::SameLine();
-  ImGui::Text("Unemployment: %.1f%%", sim.getVille().calculerTauxChomage());
+  ImGui::Text("Unemployment: %.1f%%", stats.tauxChomage);
   ImGui::SameLine();
-  ImGui::Text("Satisfaction: %d%%", sim.getVille().getSatisfaction());
+  ImGui::Text("Satisfaction: %d%%", stats.satisfaction);
   ImGui::SameLine();
-  ImGui::Text("Budget: %.2f", sim.getVille().getBudget());
+  ImGui::Text("Budget: %.2f", stats.budget);
   ImGui::SameLine();
-  ImGui::Text("Cycle Actuel: %d", sim.getCycle());
+  ImGui::Text("Cycle Actuel: %d", stats.cycle);
   ImGui::SameLine();
-  ImGui::Text("Cycle : %.1f / %.1f", sim.getCurrentTime(),
-              sim.getTimePerCycle());
+  ImGui::Text("Cycle : %.1f / %.1f", tempsCycle, etat.dureeCycle);
   ImGui::SameLine();
 
   if (ImGui::Button("Skip Month")) {
-    sim.terminerCycleEarly();
+    envoyerCommande({Commande::Type::TerminerCycle});
   }
 
   ImGui::End();
 }
 
-void Application::displayToolkit(ImGuiWindowFlags flags) {
+void Application::displayToolkit(ImGuiWindowFlags flags,
+                                 const Instantane &etat) {
   float width = window.getWidth() * 0.2;
 
   ImGuiViewport *viewport = ImGui::GetMainViewport();
@@ -179,10 +368,124 @@ void Application::displayToolkit(ImGuiWindowFlags flags) {
     ImGui::Unindent(10);
   }
   if (ImGui::CollapsingHeader("Edit", ImGuiTreeNodeFlags_DefaultOpen)) {
+    if (ImGui::Button("Build road", ImVec2(180, 0))) {
+      isPlacingRoad = !isPlacingRoad;
+      isDestroying = false;
+    }
     if (ImGui::Button("Destroy building", ImVec2(180, 0))) {
       isDestroying = !isDestroying;
+      isPlacingRoad = false;
     }
   }
+  if (ImGui::CollapsingHeader("Simulation", ImGuiTreeNodeFlags_DefaultOpen)) {
+    bool modeTrajet = etat.modeTrajet;
+    if (ImGui::Checkbox("Commute-based jobs", &modeTrajet))
+      envoyerCommande({Commande::Type::ModeTrajet, 0, 0, modeTrajet});
+    bool trafic = etat.trafic;
+    if (ImGui::Checkbox("Traffic", &trafic))
+      envoyerCommande({Commande::Type::Trafic, 0, 0, trafic});
+    bool parallele = etat.cycleParallele;
+    if (ImGui::Checkbox("Parallel cycle", &parallele))
+      envoyerCommande({Commande::Type::CycleParallele, 0, 0, parallele});
+    bool repartie = etat.repartie;
+    if (ImGui::Checkbox("Spread residents", &repartie))
+      envoyerCommande({Commande::Type::Repartie, 0, 0, repartie});
+    ImGui::Checkbox("Performance (F3)", &showPerformance);
+    ImGui::Checkbox("History", &showHistory);
+  }
+
+  ImGui::End();
+}
+
+void Application::displayHistory(const Instantane &etat) {
+  const Historique &historique = *etat.historique;
+  ImGui::SetNextWindowSize(ImVec2(420, 0), ImGuiCond_FirstUseEver);
+  ImGui::Begin("History", &showHistory, ImGuiWindowFlags_NoSavedSettings);
+
+  const char *niveaux[] = {"Every cycle", "Every 10 cycles",
+                           "Every 100 cycles"};
+  ImGui::Combo("Resolution", &historyLevel, niveaux, Historique::NIVEAUX);
+  size_t taille = historique.taille(historyLevel);
+  ImGui::Text("%zu rows, %lu cycles recorded", taille,
+              historique.getNombreReleves());
+
+  struct Serie {
+    const char *nom;
+    float Releve::*valeur;
+  };
+  const Serie series[] = {{"Budget", &Releve::budget},
+                          {"Population", &Releve::population},
+                          {"Satisfaction", &Releve::satisfaction},
+                          {"Pollution", &Releve::pollution},
+                          {"Unemployment", &Releve::chomage}};
+  std::vector<float> valeurs(taille);
+  for (const Serie &serie : series) {
+    for (size_t i = 0; i < taille; ++i)
+      valeurs[i] = historique.get(historyLevel, i).*serie.valeur;
+    char dernier[32] = "";
+    if (taille > 0)
+      std::snprintf(dernier, sizeof(dernier), "%.1f", valeurs.back());
+    ImGui::PlotLines(serie.nom, valeurs.data(), static_cast<int>(taille), 0,
+                     dernier, FLT_MAX, FLT_MAX, ImVec2(0, 50));
+  }
+  for (size_t i = 0; i < taille; ++i)
+    valeurs[i] = historique.get(historyLevel, i).evenement >= 0 ? 1.0f : 0.0f;
+  ImGui::PlotHistogram("Events", valeurs.data(), static_cast<int>(taille), 0,
+                       nullptr, 0.0f, 1.0f, ImVec2(0, 20));
+
+  if (ImGui::Button("Export CSV")) {
+    std::string chemin =
+        "history-" + std::to_string(historique.getPeriode(historyLevel)) +
+        "x.csv";
+    historyExport = historique.exporterCSV(chemin, historyLevel)
+                        ? "Saved to " + chemin
+                        : "Could not write " + chemin;
+  }
+  if (!historyExport.empty()) {
+    ImGui::SameLine();
+    ImGui::TextUnformatted(historyExport.c_str());
+  }
+
+  ImGui::End();
+}
+
+void Application::displayPerformance(const Instantane &etat) {
+  ImGuiViewport *viewport = ImGui::GetMainViewport();
+  ImGui::SetNextWindowPos(ImVec2(viewport->Size.x - 10, 10), ImGuiCond_Always,
+                          ImVec2(1.0f, 0.0f));
+  ImGui::SetNextWindowBgAlpha(0.75f);
+  ImGui::Begin("Performance", &showPerformance,
+               ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize |
+                   ImGuiWindowFlags_AlwaysAutoResize |
+                   ImGuiWindowFlags_NoSavedSettings |
+                   ImGuiWindowFlags_NoFocusOnAppearing);
+
+  float total = 0.0f, pire = 0.0f;
+  for (float t : frameTimes) {
+    total += t;
+    pire = std::max(pire, t);
+  }
+  // Slots not recorded yet hold 0 and add nothing to the total
+  float moyenne = frameCount > 0 ? total / frameCount : 0.0f;
+  ImGui::Text("Frame: %.2f ms avg, %.2f ms worst (%.0f FPS)", moyenne, pire,
+              moyenne > 0.0f ? 1000.0f / moyenne : 0.0f);
+  // Oldest frame on the left
+  ImGui::PlotHistogram("##frames", frameTimes, FRAME_HISTORY, frameIndex,
+                       nullptr, 0.0f, 33.3f, ImVec2(260, 60));
+  ImGui::Text("Draw calls: %d", drawCalls);
+  ImGui::Text("Tiles drawn: %d, culled: %d", tilesDrawn, tilesCulled);
+  ImGui::Text("Simulation step: %.3f ms", etat.dureePas);
+  if (!commandesEnAttente.empty())
+    ImGui::Text("Commands waiting: %zu", commandesEnAttente.size());
+
+  ImGui::Separator();
+  ImGui::Text("Last cycle end:");
+  double cycle = 0.0;
+  for (const auto &[nom, duree] : etat.dureesPhases) {
+    ImGui::Text("  %-12s %8.3f ms", nom.c_str(), duree);
+    cycle += duree;
+  }
+  ImGui::Text("  %-12s %8.3f ms", "sum", cycle);
 
   ImGui::End();
 }
@@ -192,70 +495,17 @@ void placeBuildingsOnTilemap(int tilemap[][64], int rows, int cols,
                              const std::vector<BatPtr> &buildings) {
   for (const auto &buildingPtr : buildings) {
     const Batiment &building = *buildingPtr;
+    const TraitsBatiment &traits = traitsDe(building.type);
 
-    int width = 1, height = 1;
-
-    switch (building.type) {
-    case TypeBatiment::Cinema:
-      width = 2;
-      height = 1;
-      break;
-    case TypeBatiment::Mall:
-      width = 3;
-      height = 3;
-      break;
-    case TypeBatiment::Park:
-      width = 2;
-      height = 2;
-      break;
-    default:
-      width = 1;
-      height = 1;
-      break;
-    }
-
-    for (int dy = 0; dy < height; ++dy) {
-      for (int dx = 0; dx < width; ++dx) {
+    for (int dy = 0; dy < traits.largeur; ++dy) {
+      for (int dx = 0; dx < traits.longeur; ++dx) {
         int x = building.position.x + dx;
         int y = building.position.y + dy;
 
         if (x < 0 || x >= cols || y < 0 || y >= rows)
           continue;
 
-        int tile = 6; // grass fallback
-
-        switch (building.type) {
-        case TypeBatiment::Cinema:
-          tile = 10 + dx;
-          break;
-        case TypeBatiment::Park:
-          tile = 15 + dy * 5 + dx;
-          break;
-        case TypeBatiment::Mall:
-          tile = 12 + dy * 5 + dx;
-          break;
-        case TypeBatiment::House:
-          tile = 0;
-          break;
-        case TypeBatiment::Apartment:
-          tile = 1;
-          break;
-        case TypeBatiment::Bank:
-          tile = 2;
-          break;
-        case TypeBatiment::PowerPlant:
-          tile = 3;
-          break;
-        case TypeBatiment::WaterTreatmentPlant:
-          tile = 4;
-          break;
-        case TypeBatiment::UtilityPlant:
-          tile = 5;
-          break;
-        default:
-          break;
-        }
-
+        int tile = traits.tuile + dy * COLONNES_ATLAS + dx;
         tilemap[y][x] = std::min(tile, tileCount - 1);
       }
     }
@@ -270,6 +520,9 @@ void Application::checkEvent() {
     if (event.type == SDL_QUIT)
       running = false;
 
+    if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3)
+      showPerformance = !showPerformance;
+
     if (event.type == SDL_MOUSEBUTTONDOWN &&
         event.button.button == SDL_BUTTON_LEFT && isDestroying) {
 
@@ -278,6 +531,10 @@ void Application::checkEvent() {
       clickMouseY = event.button.y;
     }
 
+    if (event.type == SDL_MOUSEBUTTONDOWN &&
+        event.button.button == SDL_BUTTON_LEFT && isPlacingRoad)
+      roadClickRequested = true;
+
     if (event.type == SDL_MOUSEWHEEL) {
       float oldScale = scale;
 
@@ -307,18 +564,18 @@ int Application::run() {
   sim.getVille().setBudget(10000);
   sim.getVille().calculerPolutionTotale();
   sim.getVille().calculerSatisfactionTotale();
-  sim.getVille().ajoutBatiment(Resident::createHouse(&sim.getVille(), 25, 25));
-  sim.getVille().ajoutBatiment(
-      Comercial::createCinema(&sim.getVille(), 30, 35));
-  sim.getVille().ajoutBatiment(Parc::createPark(&sim.getVille(), 10, 15));
+  BatPtr batimentsInitiaux[] = {
+      Resident::createHouse(&sim.getVille(), 25, 25),
+      Comercial::createCinema(&sim.getVille(), 30, 35),
+      Parc::createPark(&sim.getVille(), 10, 15)};
+  sim.getVille().ajoutBatiments(batimentsInitiaux);
 
   // Grid constants
-  const int ROWS = 64;
-  const int COLS = 64;
+  const int ROWS = MAP_ROWS;
+  const int COLS = MAP_COLS;
   const int TILE_SIZE = 32;
   const int TILES_X = 5;
   const int TILES_Y = 5;
-  const int TILE_COUNT = TILES_X * TILES_Y;
 
   // ----------------------------GRID-------------------------
 
@@ -330,9 +587,16 @@ int Application::run() {
   int tilemap[ROWS][COLS] = {};
   std::memcpy(tilemap, landscape, sizeof(tilemap));
 
-  // Place buildings
-  placeBuildingsOnTilemap(tilemap, ROWS, COLS, TILE_COUNT,
-                          sim.getVille().batiments);
+  // Start the simulation thread from a first snapshot
+  publierInstantane(SDL_GetPerformanceCounter());
+  std::shared_ptr<const Instantane> etat = instantanes.lire();
+  std::shared_ptr<const Instantane> etatPrecedent = etat;
+  for (int i = 0; i < ROWS * COLS; ++i)
+    if ((*etat->tuiles)[i] >= 0)
+      tilemap[i / COLS][i % COLS] = (*etat->tuiles)[i];
+  unsigned long tilemapRevision = etat->revision;
+  simulationRunning = true;
+  simulationThread = std::thread(&Application::simulationLoop, this);
 
   // Tileset source rectangles
   SDL_Rect src[TILE_COUNT];
@@ -354,11 +618,35 @@ int Application::run() {
   isDestroying = false;
 
   const Uint8 *keystate = SDL_GetKeyboardState(nullptr);
+  const double frequence = static_cast<double>(SDL_GetPerformanceFrequency());
+  Uint64 debutFrame = SDL_GetPerformanceCounter();
 
+  // Frames are paced by vsync only; the frame time scales the camera and
+  // places the frame between the last two simulation steps
   while (running) {
+    Uint64 maintenant = SDL_GetPerformanceCounter();
+    double ecoule = (maintenant - debutFrame) / frequence;
+    float dureeFrame = std::min(0.1f, static_cast<float>(ecoule));
+    debutFrame = maintenant;
+    frameTimes[frameIndex] = static_cast<float>(ecoule * 1000.0);
+    frameIndex = (frameIndex + 1) % FRAME_HISTORY;
+    frameCount = std::min(frameCount + 1, FRAME_HISTORY);
+
+    envoyerCommandesEnAttente();
     checkEvent();
-
-    float moveSpeed = speed / scale;
+    std::shared_ptr<const Instantane> lu = instantanes.lire();
+    if (lu != etat) {
+      etatPrecedent = etat;
+      etat = lu;
+    }
+    float alpha = static_cast<float>(std::clamp(
+        (maintenant / frequence - etat->horodatage) / SIM_STEP, 0.0, 1.0));
+    float tempsCycle = etat->tempsCycle;
+    if (etat->enCours && etatPrecedent->stats->cycle == etat->stats->cycle)
+      tempsCycle = etatPrecedent->tempsCycle +
+                   (etat->tempsCycle - etatPrecedent->tempsCycle) * alpha;
+
+    float moveSpeed = speed / scale * dureeFrame * 60.0f;
     if (keystate[SDL_SCANCODE_W])
       cameraY -= moveSpeed;
     if (keystate[SDL_SCANCODE_S])
@@ -402,24 +690,44 @@ int Application::run() {
         ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing;
 
     // Display UI
-    displayToolkit(flags);
+    displayToolkit(flags, *etat);
     displayInspect(flags, tileX, tileY, hoveredTile, hoveredValid, speed,
                    TILE_SIZE);
-    displayTaskBar(flags, sim);
+    displayTaskBar(flags, *etat, tempsCycle);
+    if (showPerformance) // counters of the previous frame
+      displayPerformance(*etat);
+    if (showHistory)
+      displayHistory(*etat);
 
     // ---- Destroy logic ----
-    Batiment *bat = sim.getVille().getBatimentByPos(tileX, tileY);
     if (destroyClickRequested) {
-      if (insideMap && !imguiBlockingMouse && bat) {
+      if (insideMap && !imguiBlockingMouse)
+        envoyerCommande({Commande::Type::Detruire, tileX, tileY});
 
-        sim.getVille().supprimerBatiment(bat->position.x, bat->position.y);
+      destroyClickRequested = false; // always clear
+    }
+    if (roadClickRequested) {
+      if (insideMap && !imguiBlockingMouse)
+        envoyerCommande({Commande::Type::AjouterRoute, tileX, tileY});
+      roadClickRequested = false;
+    }
 
-        std::memcpy(tilemap, landscape, sizeof(tilemap));
-        placeBuildingsOnTilemap(tilemap, ROWS, COLS, TILE_COUNT,
-                                sim.getVille().batiments);
+    // Follow the city edits: patch the tiles that changed since the
+    // snapshot we drew last, or redo the whole map if some were skipped
+    if (etat->revision != tilemapRevision) {
+      auto appliquer = [&](int i) {
+        int tile = (*etat->tuiles)[i];
+        tilemap[i / COLS][i % COLS] =
+            tile >= 0 ? tile : landscape[i / COLS][i % COLS];
+      };
+      if (etat->revisionPrecedente == tilemapRevision) {
+        for (int i : etat->tuilesModifiees)
+          appliquer(i);
+      } else {
+        for (int i = 0; i < ROWS * COLS; ++i)
+          appliquer(i);
       }
-
-      destroyClickRequested = false; // always clear
+      tilemapRevision = etat->revision;
     }
 
     ImGui::Render();
@@ -427,14 +735,43 @@ int Application::run() {
     SDL_SetRenderDrawColor(renderer, 35, 35, 35, 255);
     SDL_RenderClear(renderer);
 
+    // Only the tiles inside the window are drawn
+    int outputW, outputH;
+    SDL_GetRendererOutputSize(renderer, &outputW, &outputH);
+    float tileScreen = TILE_SIZE * scale;
+    int firstX = std::clamp(int(cameraX / TILE_SIZE), 0, COLS);
+    int firstY = std::clamp(int(cameraY / TILE_SIZE), 0, ROWS);
+    int lastX = std::clamp(int((cameraX + outputW / scale) / TILE_SIZE) + 1,
+                           firstX, COLS);
+    int lastY = std::clamp(int((cameraY + outputH / scale) / TILE_SIZE) + 1,
+                           firstY, ROWS);
+    drawCalls = 0;
+    tilesDrawn = (lastX - firstX) * (lastY - firstY);
+    tilesCulled = ROWS * COLS - tilesDrawn;
+
     // Render tiles
-    for (int y = 0; y < ROWS; ++y) {
-      for (int x = 0; x < COLS; ++x) {
+    for (int y = firstY; y < lastY; ++y) {
+      for (int x = firstX; x < lastX; ++x) {
         int tile = tilemap[y][x];
         SDL_Rect dest = {int((x * TILE_SIZE - cameraX) * scale),
                          int((y * TILE_SIZE - cameraY) * scale),
-                         int(TILE_SIZE * scale), int(TILE_SIZE * scale)};
+                         int(tileScreen), int(tileScreen)};
         SDL_RenderCopy(renderer, window.getTexture(), &src[tile], &dest);
+        ++drawCalls;
+      }
+    }
+
+    // Roads (the tileset has no road tile)
+    SDL_SetRenderDrawColor(renderer, 90, 90, 90, 255);
+    for (int y = firstY; y < lastY; ++y) {
+      for (int x = firstX; x < lastX; ++x) {
+        if (!(*etat->routes)[y * COLS + x])
+          continue;
+        SDL_Rect dest = {int((x * TILE_SIZE - cameraX) * scale),
+                         int((y * TILE_SIZE - cameraY) * scale),
+                         int(tileScreen), int(tileScreen)};
+        SDL_RenderFillRect(renderer, &dest);
+        ++drawCalls;
       }
     }
 
@@ -445,17 +782,22 @@ int Application::run() {
                           int(TILE_SIZE * scale), int(TILE_SIZE * scale)};
       if (isDestroying)
         SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+      else if (isPlacingRoad)
+        SDL_SetRenderDrawColor(renderer, 255, 200, 0, 255);
       else
         SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
       SDL_RenderDrawRect(renderer, &outline);
+      ++drawCalls;
     }
 
-    ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), renderer);
+    ImDrawData *drawData = ImGui::GetDrawData();
+    for (int i = 0; i < drawData->CmdListsCount; ++i)
+      drawCalls += drawData->CmdLists[i]->CmdBuffer.Size;
+    ImGui_ImplSDLRenderer2_RenderDrawData(drawData, renderer);
     SDL_RenderPresent(renderer);
-
-    SDL_Delay(16);
-    sim.tick(0.016f);
   }
 
+  stopSimulation();
+
   return exitStatus;
 }
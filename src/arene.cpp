@@ -0,0 +1,18 @@
+#include "../include/ville/arene.hpp"
+
+void SuppressionBatiment::operator()(Batiment *batiment) const {
+  if (liberer)
+    liberer(pool, batiment);
+  else
+    delete batiment;
+}
+
+size_t AreneBatiments::getNombreObjets() const {
+  return std::apply(
+      [](const auto &...pool) { return (pool.getVivants() + ...); }, pools);
+}
+
+size_t AreneBatiments::getCapacite() const {
+  return std::apply(
+      [](const auto &...pool) { return (pool.getCapacite() + ...); }, pools);
+}
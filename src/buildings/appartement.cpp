@@ -1,7 +1,8 @@
 #include "../../include/buildings/appartement.hpp"
+#include "../../include/buildings/traits.hpp"
 #include <stdexcept>
 
-Appartement::Appartement(int id, const std::string &nom, Ville *ville,
+Appartement::Appartement(int id, std::string_view nom, Ville *ville,
                          TypeBatiment type, int effectSatisfication,
                          double cost, Resources consommation, float polution,
                          Position position, Surface surface,
@@ -12,7 +13,7 @@ Appartement::Appartement(int id, const std::string &nom, Ville *ville,
                polution, position, surface, capaciteHabitants,
                habitantsActuels) {}
 
-Appartement::Appartement(int id, const std::string &nom, Ville *ville,
+Appartement::Appartement(int id, std::string_view nom, Ville *ville,
                          TypeBatiment type, int effectSatisfication,
                          double cost, double consommationEau,
                          double consommationElectricte, float polution, int x,
@@ -40,7 +41,7 @@ void Appartement::addNewFloor() {
   }
 }
 
-Appartement Appartement::createAppartement(int id, const string &nom,
+Appartement Appartement::createAppartement(int id, string_view nom,
                                            Ville *ville,
                                            unsigned int floorsCount, int x,
                                            int y) {
@@ -48,17 +49,16 @@ Appartement Appartement::createAppartement(int id, const string &nom,
     std::invalid_argument("Floor count connot execed 4.");
   }
   
-  // Auto-generate name and ID
-  string generatedName = NameGenerator::getRandomName(TypeBatiment::Apartment);
-  Position position(x, y);
-  Surface surface(1, 1);
-  int generatedID = BuildingIDGenerator::generateID(generatedName, TypeBatiment::Apartment, position, surface);
+  // Auto-generate name, the id comes from the city
+  string_view generatedName = NameGenerator::getRandomName(TypeBatiment::Apartment);
+  const TraitsBatiment &traits = traitsDe(TypeBatiment::Apartment);
   
-  return Appartement(generatedID, generatedName, ville, TypeBatiment::Apartment,
+  return Appartement(0, generatedName, ville, TypeBatiment::Apartment,
                      EFFET_SATISFACTION_PER_FLOOR * floorsCount,
                      COST_PER_FLOOR * floorsCount,
                      CONSOMMATION_EAU_PER_FLOOR * floorsCount,
                      CONSOMMATION_ELE_PER_FLOOR * floorsCount,
-                     POLUTION_PER_FLOOR * floorsCount, x, y, 1, 1,
+                     POLUTION_PER_FLOOR * floorsCount, x, y,
+                     traits.longeur, traits.largeur,
                      MAX_HABITATS_PER_FLOOR * floorsCount, 0, floorsCount);
 }
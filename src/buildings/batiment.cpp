@@ -1,4 +1,5 @@
 #include "../../include/buildings/batiment.hpp"
+#include "../../include/buildings/traits.hpp"
 
 #include <iostream>
 #include <string>
@@ -26,24 +27,25 @@ void Batiment::setPopulationBuildingFactor(float factor) {
   POPULATION_BUILDING_FACTOR = factor;
 }
 // Constructors
-Batiment::Batiment(int id, const string &nom, Ville *ville, TypeBatiment type,
+Batiment::Batiment(int id, string_view nom, Ville *ville, TypeBatiment type,
                    int effectSatisfication, double cost, double consommationEau,
                    double consommationElectricite, float polution, int x, int y,
                    int largeur, int longeur)
-    : id(id), nom(nom), ville(ville), type(type),
+    : id(id), nom(TableNoms::interner(nom)), ville(ville), type(type),
       effectSatisfication(effectSatisfication), cost(cost),
-      consommation(consommationEau, consommationElectricite), position(x, y),
-      surface(largeur, longeur) {
+      consommation(consommationEau, consommationElectricite),
+      polution(polution), position(x, y), surface(largeur, longeur) {
   if (ville)
     ville->setBudget(ville->getBudget() - cost);
 }
 
-Batiment::Batiment(int id, const string &nom, Ville *ville, TypeBatiment type,
+Batiment::Batiment(int id, string_view nom, Ville *ville, TypeBatiment type,
                    int effectSatisfication, double cost, Resources consommation,
                    float polution, Position position, Surface surface)
-    : id(id), nom(nom), ville(ville), type(type),
+    : id(id), nom(TableNoms::interner(nom)), ville(ville), type(type),
       effectSatisfication(effectSatisfication), cost(cost),
-      consommation(consommation), position(position), surface(surface) {
+      consommation(consommation), polution(polution), position(position),
+      surface(surface) {
   if (ville)
     ville->setBudget(ville->getBudget() - cost);
 }
@@ -53,13 +55,11 @@ void Batiment::afficheDetails() const {
   if (ImGui::CollapsingHeader("Building Info",
                               ImGuiTreeNodeFlags_DefaultOpen)) {
     ImGui::Text("ID: %d", id);
-    ImGui::Text("Name: %s", nom.c_str());
+    string_view nomAffiche = getNom();
+    ImGui::Text("Name: %.*s", static_cast<int>(nomAffiche.size()),
+                nomAffiche.data());
     // Type
-    ImGui::Text("Type: %s", type == TypeBatiment::House    ? "House"
-                            : type == TypeBatiment::Cinema ? "Cinema"
-                            : type == TypeBatiment::Mall   ? "Mall"
-                            : type == TypeBatiment::Park   ? "Park"
-                                                           : "Unknown");
+    ImGui::Text("Type: %s", traitsDe(type).nom);
     ImGui::Text("effectSatisfication %d %%", effectSatisfication);
     ImGui::Text("Cost %.2f", cost);
     ImGui::Text("consommationEau  : %.3f Litre/s", consommation.eau);
@@ -70,14 +70,10 @@ void Batiment::afficheDetails() const {
   }
 }
 
-void Batiment::impacterRessources() {
-  ville->setResources(ville->getResources() - consommation);
-}
-
 // getters
 int Batiment::getID() { return id; }
 Resources Batiment::getconsommation() { return consommation; }
 int Batiment::getSatisfaction() { return effectSatisfication; }
 float Batiment::getPolution() { return polution; }
 double Batiment::getCost() { return cost; }
-string Batiment::getNom() const { return nom; }
+string_view Batiment::getNom() const { return TableNoms::get(nom); }
@@ -1,4 +1,6 @@
 #include "../../include/buildings/commercial.hpp"
+#include "../../include/buildings/traits.hpp"
+#include "../../include/ville/arene.hpp"
 
 #include <iostream>
 #include <string>
@@ -31,7 +33,7 @@ void Comercial::setBaseEmployeesCinema(int value) {
 void Comercial::setBaseEmployeesMall(int value) { BASE_EMPLOYEES_MALL = value; }
 void Comercial::setBaseEmployeesBank(int value) { BASE_EMPLOYEES_BANK = value; }
 
-Comercial::Comercial(int id, const string &nom, Ville *ville, TypeBatiment type,
+Comercial::Comercial(int id, string_view nom, Ville *ville, TypeBatiment type,
                      int effectSatisfication, double cost,
                      unsigned int Employees, unsigned int EmployeesNeeded,
                      double consommationEau, double consommationElectricite,
@@ -42,7 +44,7 @@ Comercial::Comercial(int id, const string &nom, Ville *ville, TypeBatiment type,
               EmployeesNeeded, consommationEau, consommationElectricite,
               polution, x, y, largeur, longeur) {}
 
-Comercial::Comercial(int id, const string &nom, Ville *ville, TypeBatiment type,
+Comercial::Comercial(int id, string_view nom, Ville *ville, TypeBatiment type,
                      int effectSatisfication, double cost,
                      unsigned int Employees, unsigned int EmployeesNeeded,
                      Resources consommation, float polution, Position position,
@@ -52,56 +54,56 @@ Comercial::Comercial(int id, const string &nom, Ville *ville, TypeBatiment type,
               EmployeesNeeded, consommation, polution, position, surface) {}
 
 BatPtr Comercial::createCinema(Ville *ville, int x, int y) {
-  // Auto-generate name and ID
-  string generatedName = NameGenerator::getRandomName(TypeBatiment::Cinema);
-  Position position(x, y);
-  Surface surface(2, 1);
-  int generatedID = BuildingIDGenerator::generateID(
-      generatedName, TypeBatiment::Cinema, position, surface);
+  // Auto-generate name, the id comes from the city
+  string_view generatedName = NameGenerator::getRandomName(TypeBatiment::Cinema);
+  const TraitsBatiment &traits = traitsDe(TypeBatiment::Cinema);
 
   float baseProfit = PROFIT_PER_EMPLOYEE * BASE_EMPLOYEES_CINEMA;
   int satisfaction = static_cast<int>(100 * SATISFACTION_BONUS);
   float pollution = 2.5f * (1.0f + POLLUTION_PENALTY);
 
-  return BatPtr(new Comercial(generatedID, generatedName, ville,
-                              TypeBatiment::Cinema, satisfaction, 500.0, 0,
-                              BASE_EMPLOYEES_CINEMA, 10, 30, pollution, x, y, 2,
-                              1, baseProfit));
+  return creerBatiment<Comercial>(ville, [&](void *place) {
+    return new (place)
+        Comercial(0, generatedName, ville, TypeBatiment::Cinema,
+                  satisfaction, 500.0, 0, BASE_EMPLOYEES_CINEMA, 10, 30,
+                  pollution, x, y, traits.longeur, traits.largeur,
+                  baseProfit);
+  });
 }
 
 BatPtr Comercial::createMall(Ville *ville, int x, int y) {
-  // Auto-generate name and ID
-  string generatedName = NameGenerator::getRandomName(TypeBatiment::Mall);
-  Position position(x, y);
-  Surface surface(3, 3);
-  int generatedID = BuildingIDGenerator::generateID(
-      generatedName, TypeBatiment::Mall, position, surface);
+  // Auto-generate name, the id comes from the city
+  string_view generatedName = NameGenerator::getRandomName(TypeBatiment::Mall);
+  const TraitsBatiment &traits = traitsDe(TypeBatiment::Mall);
 
   float baseProfit =
       PROFIT_PER_EMPLOYEE * BASE_EMPLOYEES_MALL * EMPLOYEE_EFFICIENCY;
   int satisfaction = static_cast<int>(100 * SATISFACTION_BONUS);
   float pollution = 8.0f * (1.0f + POLLUTION_PENALTY);
 
-  return BatPtr(new Comercial(generatedID, generatedName, ville,
-                              TypeBatiment::Mall, satisfaction, 2000.0, 0,
-                              BASE_EMPLOYEES_MALL, 400, 600, pollution, x, y, 3,
-                              3, baseProfit));
+  return creerBatiment<Comercial>(ville, [&](void *place) {
+    return new (place)
+        Comercial(0, generatedName, ville, TypeBatiment::Mall,
+                  satisfaction, 2000.0, 0, BASE_EMPLOYEES_MALL, 400, 600,
+                  pollution, x, y, traits.longeur, traits.largeur,
+                  baseProfit);
+  });
 }
 
 BatPtr Comercial::createBank(Ville *ville, int x, int y) {
-  // Auto-generate name and ID
-  string generatedName = NameGenerator::getRandomName(TypeBatiment::Bank);
-  Position position(x, y);
-  Surface surface(1, 1);
-  int generatedID = BuildingIDGenerator::generateID(
-      generatedName, TypeBatiment::Bank, position, surface);
+  // Auto-generate name, the id comes from the city
+  string_view generatedName = NameGenerator::getRandomName(TypeBatiment::Bank);
+  const TraitsBatiment &traits = traitsDe(TypeBatiment::Bank);
 
   float baseProfit = PROFIT_PER_EMPLOYEE * BASE_EMPLOYEES_BANK * 2.5f;
   float pollution = 2.0f * (1.0f + POLLUTION_PENALTY);
 
-  return BatPtr(new Comercial(
-      generatedID, generatedName, ville, TypeBatiment::Bank, -20, 2000.0, 0,
-      BASE_EMPLOYEES_BANK, 10, 30, pollution, x, y, 1, 1, baseProfit));
+  return creerBatiment<Comercial>(ville, [&](void *place) {
+    return new (place) Comercial(
+        0, generatedName, ville, TypeBatiment::Bank, -20, 2000.0, 0,
+        BASE_EMPLOYEES_BANK, 10, 30, pollution, x, y, traits.longeur,
+        traits.largeur, baseProfit);
+  });
 }
 
 // Methods
@@ -109,16 +111,17 @@ void Comercial::afficheDetails() const {
   Service::afficheDetails();
   if (ImGui::CollapsingHeader("Commercial Info", ImGuiTreeNodeFlags_DefaultOpen)) {
     ImGui::Text("Profit %.2f", profit);
+    ImGui::Text("Income %.2f", getProfit());
     ImGui::Text("Profit par employe %.2f", PROFIT_PER_EMPLOYEE);
     ImGui::Text("Bonus satisfaction %.2f", SATISFACTION_BONUS);
   }
 }
 
 // Getters
-double Comercial::getProfit() {
-  // Calcul
+double Comercial::getProfitBase() const { return profit; }
+
+double Comercial::getProfit() const {
   float efficiency =
       (Employees >= EmployeesNeeded) ? 1.0f : EMPLOYEE_EFFICIENCY;
-  return profit * efficiency *
-         (1.0f - (ville->getPolution() * POLLUTION_PENALTY / 100.0f));
+  return profit * efficiency * (ville ? ville->getFacteurProfit() : 1.0);
 }
@@ -1,10 +1,12 @@
 #include "../../include/buildings/infrastructure.hpp"
+#include "../../include/buildings/traits.hpp"
+#include "../../include/ville/arene.hpp"
 
 #include <string>
 
 using namespace std;
 
-Infrastructure::Infrastructure(int id, const string &nom, Ville *ville,
+Infrastructure::Infrastructure(int id, string_view nom, Ville *ville,
                                TypeBatiment type, int effectSatisfication,
                                double cost, unsigned int employees,
                                unsigned int employeesNeeded,
@@ -15,9 +17,9 @@ Infrastructure::Infrastructure(int id, const string &nom, Ville *ville,
     : productionRessources(productionRessources),
       Service(id, nom, ville, type, effectSatisfication, cost, employees,
               employeesNeeded, consommationEau, consommationElectricite,
-              polution, x, y, largeur, longeur) {}
+              pollution, x, y, largeur, longeur) {}
 
-Infrastructure::Infrastructure(int id, const string &nom, Ville *ville,
+Infrastructure::Infrastructure(int id, string_view nom, Ville *ville,
                                TypeBatiment type, int effectSatisfication,
                                double cost, unsigned int employees,
                                unsigned int employeesNeeded,
@@ -27,52 +29,57 @@ Infrastructure::Infrastructure(int id, const string &nom, Ville *ville,
                                Resources productionRessources)
     : productionRessources(productionRessources),
       Service(id, nom, ville, type, effectSatisfication, cost, employees,
-              employeesNeeded, consommation, polution, position, surface) {}
+              employeesNeeded,
+              Resources(consommationEau, consommationElectricite), pollution,
+              position, surface) {}
 
-Infrastructure Infrastructure::createPowerPlant(int id, const string &nom,
-                                                Ville *ville, int x, int y) {
-  // Auto-generate name and ID
-  string generatedName = NameGenerator::getRandomName(TypeBatiment::PowerPlant);
-  Position position(x, y);
-  Surface surface(1, 1);
-  int generatedID = BuildingIDGenerator::generateID(generatedName, TypeBatiment::PowerPlant, position, surface);
+BatPtr Infrastructure::createPowerPlant(Ville *ville, int x, int y) {
+  // Auto-generate name, the id comes from the city
+  string_view generatedName = NameGenerator::getRandomName(TypeBatiment::PowerPlant);
+  const TraitsBatiment &traits = traitsDe(TypeBatiment::PowerPlant);
   
-  return Infrastructure(generatedID, generatedName, ville, TypeBatiment::PowerPlant, -2, 20.0, 0,
-                        40, 3.0, 0.0, 20, x, y, 1, 1, Resources(0.0, 200.0));
+  return creerBatiment<Infrastructure>(ville, [&](void *place) {
+    return new (place) Infrastructure(
+        0, generatedName, ville, TypeBatiment::PowerPlant, -2, 20.0,
+        0, 40, 3.0, 0.0, 20, x, y, traits.longeur, traits.largeur,
+        Resources(0.0, 200.0));
+  });
 }
 
-Infrastructure Infrastructure::createWaterTreatmentPlant(int id,
-                                                         const string &nom,
-                                                         Ville *ville, int x,
-                                                         int y) {
-  // Auto-generate name and ID
-  string generatedName = NameGenerator::getRandomName(TypeBatiment::WaterTreatmentPlant);
-  Position position(x, y);
-  Surface surface(1, 1);
-  int generatedID = BuildingIDGenerator::generateID(generatedName, TypeBatiment::WaterTreatmentPlant, position, surface);
+BatPtr Infrastructure::createWaterTreatmentPlant(Ville *ville, int x, int y) {
+  // Auto-generate name, the id comes from the city
+  string_view generatedName = NameGenerator::getRandomName(TypeBatiment::WaterTreatmentPlant);
+  const TraitsBatiment &traits = traitsDe(TypeBatiment::WaterTreatmentPlant);
   
-  return Infrastructure(generatedID, generatedName, ville, TypeBatiment::WaterTreatmentPlant, -2,
-                        20.0, 0, 40, 0.0, 7.0, 15, x, y, 1, 1,
-                        Resources(200.0, 0.0));
+  return creerBatiment<Infrastructure>(ville, [&](void *place) {
+    return new (place) Infrastructure(
+        0, generatedName, ville, TypeBatiment::WaterTreatmentPlant,
+        -2, 20.0, 0, 40, 0.0, 7.0, 15, x, y, traits.longeur, traits.largeur,
+        Resources(200.0, 0.0));
+  });
 }
 
-Infrastructure Infrastructure::createUtilityPlant(int id, const string &nom,
-                                                  Ville *ville, int x, int y) {
-  // Auto-generate name and ID
-  string generatedName = NameGenerator::getRandomName(TypeBatiment::UtilityPlant);
-  Position position(x, y);
-  Surface surface(1, 1);
-  int generatedID = BuildingIDGenerator::generateID(generatedName, TypeBatiment::UtilityPlant, position, surface);
+BatPtr Infrastructure::createUtilityPlant(Ville *ville, int x, int y) {
+  // Auto-generate name, the id comes from the city
+  string_view generatedName = NameGenerator::getRandomName(TypeBatiment::UtilityPlant);
+  const TraitsBatiment &traits = traitsDe(TypeBatiment::UtilityPlant);
   
-  return Infrastructure(generatedID, generatedName, ville, TypeBatiment::UtilityPlant, -6, 60.0, 0,
-                        45, 0.0, 0.0, 45, x, y, 1, 1, Resources(150.0, 150.0));
+  return creerBatiment<Infrastructure>(ville, [&](void *place) {
+    return new (place) Infrastructure(
+        0, generatedName, ville, TypeBatiment::UtilityPlant, -6,
+        60.0, 0, 45, 0.0, 0.0, 45, x, y, traits.longeur, traits.largeur,
+        Resources(150.0, 150.0));
+  });
 }
 
-void Infrastructure::impacterRessources() {
-  ville->setResources(ville->getResources() - consommation +
-                      productionRessources);
-}
+// Getters
+Resources Infrastructure::getProduction() const { return productionRessources; }
 
-void Infrastructure::produireRessources() {
-  ville->setResources(ville->getResources() + productionRessources);
+Resources Infrastructure::getProductionEffective() const {
+  // Utility plants do not hire, they always run at full output
+  if (EmployeesNeeded == 0 || type == TypeBatiment::UtilityPlant)
+    return productionRessources;
+  double ratio = static_cast<double>(Employees) / EmployeesNeeded;
+  return Resources(productionRessources.eau * ratio,
+                   productionRessources.electricite * ratio);
 }
@@ -1,14 +1,16 @@
 #include "../../include/buildings/parc.hpp"
+#include "../../include/buildings/traits.hpp"
+#include "../../include/ville/arene.hpp"
 #include <iostream>
 
-Parc::Parc(int id, const string &nom, Ville *ville, TypeBatiment type,
+Parc::Parc(int id, string_view nom, Ville *ville, TypeBatiment type,
            int effectSatisfication, double cost, unsigned int Employees,
            unsigned int EmployeesNeeded, Resources consommation, float polution,
            Position position, Surface surface)
     : Service(id, nom, ville, type, effectSatisfication, cost, Employees,
               EmployeesNeeded, consommation, polution, position, surface) {}
 
-Parc::Parc(int id, const string &nom, Ville *ville, TypeBatiment type,
+Parc::Parc(int id, string_view nom, Ville *ville, TypeBatiment type,
            int effectSatisfication, double cost, unsigned int Employees,
            unsigned int EmployeesNeeded, double consommationEau,
            double consommationElectricite, float polution, int x, int y,
@@ -18,8 +20,9 @@ Parc::Parc(int id, const string &nom, Ville *ville, TypeBatiment type,
               polution, x, y, largeur, longeur) {}
 
 void Parc::diminuerPollution() {
-  ville->setPolution(ville->getPolution() - (surface.largeur * surface.longeur *
-                                             Parc::POLLUTION_REDUCTION_FACTOR));
+  // Each covered tile absorbs POLLUTION_REDUCTION_FACTOR % per step
+  ville->getChampPollution().ajouterPuits(
+      position, surface, Parc::POLLUTION_REDUCTION_FACTOR / 100.0f);
 }
 
 void Parc::ameliorerBienEtre() {
@@ -37,11 +40,9 @@ void Parc::afficheDetails() const {
 }
 
 BatPtr Parc::createPark(Ville *ville, int x, int y) {
-  // Auto-generate name and ID
-  string generatedName = NameGenerator::getRandomName(TypeBatiment::Park);
-  Position position(x, y);
-  Surface surface(2, 2);
-  int generatedID = BuildingIDGenerator::generateID(generatedName, TypeBatiment::Park, position, surface);
+  // Auto-generate name, the id comes from the city
+  string_view generatedName = NameGenerator::getRandomName(TypeBatiment::Park);
+  const TraitsBatiment &traits = traitsDe(TypeBatiment::Park);
   
   // Parks: 2x2 surface, reduce pollution, use water for plants/fountains, minimal electricity
   // Realistic values for a park:
@@ -53,7 +54,8 @@ BatPtr Parc::createPark(Ville *ville, int x, int y) {
   // - Employees: 8 (maintenance staff)
   // - Employees needed: 8
   
-  return BatPtr( new Parc(generatedID, generatedName, ville, TypeBatiment::Park, 
+  return creerBatiment<Parc>(ville, [&](void *place) {
+    return new (place) Parc(0, generatedName, ville, TypeBatiment::Park,
               80,           // satisfaction
               1500.0,       // cost
               8,            // employees
@@ -61,6 +63,7 @@ BatPtr Parc::createPark(Ville *ville, int x, int y) {
               25.0,         // water consumption
               5.0,          // electricity consumption
               -15.0f,       // pollution (negative = reduces)
-              x, y, 2, 2));  // position and surface (2x2)
+              x, y, traits.longeur, traits.largeur); // position and surface
+  });
 }
 
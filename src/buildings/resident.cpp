@@ -1,4 +1,6 @@
 #include "../../include/buildings/resident.hpp"
+#include "../../include/buildings/traits.hpp"
+#include "../../include/ville/arene.hpp"
 
 #include <iostream>
 #include <string>
@@ -23,7 +25,7 @@ void Resident::setBaseCapacityHouse(int value) { BASE_CAPACITY_HOUSE = value; }
 void Resident::setBaseCapacityApartment(int value) { BASE_CAPACITY_APARTMENT = value; }
 
 // Constructor
-Resident::Resident(int id, const std::string &nom, Ville *ville,
+Resident::Resident(int id, std::string_view nom, Ville *ville,
                    TypeBatiment type, int effectSatisfication, double cost,
                    double consommationEau, double consommationElectricite,
                    float polution, int x, int y, int largeur, int longeur,
@@ -32,7 +34,7 @@ Resident::Resident(int id, const std::string &nom, Ville *ville,
       Batiment(id, nom, ville, type, effectSatisfication, cost, consommationEau,
                consommationElectricite, polution, x, y, largeur, longeur) {}
 
-Resident::Resident(int id, const std::string &nom, Ville *ville,
+Resident::Resident(int id, std::string_view nom, Ville *ville,
                    TypeBatiment type, int effectSatisfication, double cost,
                    Resources consommation, float polution, Position position,
                    Surface surface, int capaciteHabitants, int habitantsActuels)
@@ -73,11 +75,9 @@ void Resident::retirerHabitants(int nombreHabitants) {
 
 BatPtr Resident::createHouse(Ville *ville,
                              int x, int y) {
-    // Auto-generate name and ID
-    string generatedName = NameGenerator::getRandomName(TypeBatiment::House);
-    Position position(x, y);
-    Surface surface(1, 1);
-    int generatedID = BuildingIDGenerator::generateID(generatedName, TypeBatiment::House, position, surface);
+    // Auto-generate name, the id comes from the city
+    string_view generatedName = NameGenerator::getRandomName(TypeBatiment::House);
+    const TraitsBatiment &traits = traitsDe(TypeBatiment::House);
     
     float pollution = POLLUTION_PER_PERSON * BASE_CAPACITY_HOUSE;
     int satisfaction = static_cast<int>(
@@ -86,15 +86,15 @@ BatPtr Resident::createHouse(Ville *ville,
     float water = WATER_PER_PERSON * BASE_CAPACITY_HOUSE;
     float electricity = ELECTRICITY_PER_PERSON * BASE_CAPACITY_HOUSE;
 
-    return BatPtr(
-        new Resident(
-            generatedID, generatedName, ville, TypeBatiment::House,
+    return creerBatiment<Resident>(ville, [&](void *place) {
+        return new (place) Resident(
+            0, generatedName, ville, TypeBatiment::House,
             satisfaction, 30.0,
             water, electricity, pollution,
-            x, y, 1, 1,
+            x, y, traits.longeur, traits.largeur,
             BASE_CAPACITY_HOUSE, 0
-        )
-    );
+        );
+    });
 }
 
 
@@ -3,7 +3,7 @@
 
 using namespace std;
 
-Service::Service(int id, const string &nom, Ville *ville, TypeBatiment type,
+Service::Service(int id, string_view nom, Ville *ville, TypeBatiment type,
                  int effectSatisfication, double cost, unsigned int Employees,
                  unsigned int EmployeesNeeded, double consommationEau,
                  double consommationElectricite, float polution, int x, int y,
@@ -12,7 +12,7 @@ Service::Service(int id, const string &nom, Ville *ville, TypeBatiment type,
       Batiment(id, nom, ville, type, effectSatisfication, cost, consommationEau,
                consommationElectricite, polution, x, y, largeur, longeur) {}
 
-Service::Service(int id, const string &nom, Ville *ville, TypeBatiment type,
+Service::Service(int id, string_view nom, Ville *ville, TypeBatiment type,
                  int effectSatisfication, double cost, unsigned int Employees,
                  unsigned int EmployeesNeeded, Resources consommation,
                  float polution, Position position, Surface surface)
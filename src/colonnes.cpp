@@ -0,0 +1,233 @@
+#include "../include/ville/colonnes.hpp"
+#include "../include/buildings/batiment.hpp"
+#include "../include/buildings/traits.hpp"
+#include "../include/cycle/parallele.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COLONNES_AVX
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Element i of a column goes to partial sum i % VOIES, the partial sums are
+// combined in a fixed order at the end
+constexpr size_t VOIES = 8;
+
+double combiner(const double *s) {
+  return ((s[0] + s[4]) + (s[1] + s[5])) + ((s[2] + s[6]) + (s[3] + s[7]));
+}
+
+double sommerScalaire(const double *v, size_t n) {
+  double s[VOIES] = {};
+  size_t i = 0;
+  for (; i + VOIES <= n; i += VOIES)
+    for (size_t k = 0; k < VOIES; ++k)
+      s[k] += v[i + k];
+  for (; i < n; ++i)
+    s[i % VOIES] += v[i];
+  return combiner(s);
+}
+
+double sommerRapportsScalaire(const double *a, const double *b, size_t n) {
+  double s[VOIES] = {};
+  size_t i = 0;
+  for (; i + VOIES <= n; i += VOIES)
+    for (size_t k = 0; k < VOIES; ++k)
+      s[k] += a[i + k] / (b[i + k] + 1.0);
+  for (; i < n; ++i)
+    s[i % VOIES] += a[i] / (b[i] + 1.0);
+  return combiner(s);
+}
+
+#ifdef COLONNES_AVX
+__attribute__((target("avx"))) double sommerAvx(const double *v, size_t n) {
+  __m256d bas = _mm256_setzero_pd();
+  __m256d haut = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + VOIES <= n; i += VOIES) {
+    bas = _mm256_add_pd(bas, _mm256_loadu_pd(v + i));
+    haut = _mm256_add_pd(haut, _mm256_loadu_pd(v + i + 4));
+  }
+  double s[VOIES];
+  _mm256_storeu_pd(s, bas);
+  _mm256_storeu_pd(s + 4, haut);
+  for (; i < n; ++i)
+    s[i % VOIES] += v[i];
+  return combiner(s);
+}
+
+__attribute__((target("avx"))) double
+sommerRapportsAvx(const double *a, const double *b, size_t n) {
+  const __m256d un = _mm256_set1_pd(1.0);
+  __m256d bas = _mm256_setzero_pd();
+  __m256d haut = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + VOIES <= n; i += VOIES) {
+    bas = _mm256_add_pd(
+        bas, _mm256_div_pd(_mm256_loadu_pd(a + i),
+                           _mm256_add_pd(_mm256_loadu_pd(b + i), un)));
+    haut = _mm256_add_pd(
+        haut, _mm256_div_pd(_mm256_loadu_pd(a + i + 4),
+                            _mm256_add_pd(_mm256_loadu_pd(b + i + 4), un)));
+  }
+  double s[VOIES];
+  _mm256_storeu_pd(s, bas);
+  _mm256_storeu_pd(s + 4, haut);
+  for (; i < n; ++i)
+    s[i % VOIES] += a[i] / (b[i] + 1.0);
+  return combiner(s);
+}
+#endif
+
+struct Noyaux {
+  double (*sommer)(const double *, size_t);
+  double (*sommerRapports)(const double *, const double *, size_t);
+  const char *nom;
+};
+
+bool disponible(const char *nom) {
+#ifdef COLONNES_AVX
+  __builtin_cpu_init();
+  if (std::strcmp(nom, "avx") == 0)
+    return __builtin_cpu_supports("avx");
+#endif
+  return std::strcmp(nom, "scalar") == 0;
+}
+
+const Noyaux NOYAUX[] = { // widest first
+#ifdef COLONNES_AVX
+    {sommerAvx, sommerRapportsAvx, "avx"},
+#endif
+    {sommerScalaire, sommerRapportsScalaire, "scalar"},
+};
+
+// Picked once, the widest kernels available
+const Noyaux *&noyaux() {
+  static const Noyaux *choisis = [] {
+    for (const Noyaux &n : NOYAUX)
+      if (disponible(n.nom))
+        return &n;
+    return &NOYAUX[std::size(NOYAUX) - 1];
+  }();
+  return choisis;
+}
+
+// Long columns are summed in fixed-size chunks spread over the pool, the
+// chunk totals are then added in chunk order: how many threads ran them
+// does not change the result
+constexpr size_t TRANCHE = 1 << 16;
+
+template <class Noyau> double reduire(size_t n, Noyau noyau) {
+  if (n <= TRANCHE)
+    return noyau(0, n);
+  std::vector<double> partielles((n + TRANCHE - 1) / TRANCHE);
+  executerEnParallele(partielles.size(), [&](size_t t) {
+    size_t debut = t * TRANCHE;
+    partielles[t] = noyau(debut, std::min(TRANCHE, n - debut));
+  });
+  double total = 0.0;
+  for (double p : partielles)
+    total += p;
+  return total;
+}
+
+double sommer(const std::vector<double> &v) {
+  auto noyau = noyaux()->sommer;
+  return reduire(v.size(), [&](size_t debut, size_t nombre) {
+    return noyau(v.data() + debut, nombre);
+  });
+}
+
+double sommerRapports(const std::vector<double> &a,
+                      const std::vector<double> &b) {
+  auto noyau = noyaux()->sommerRapports;
+  return reduire(a.size(), [&](size_t debut, size_t nombre) {
+    return noyau(a.data() + debut, b.data() + debut, nombre);
+  });
+}
+
+} // namespace
+
+uint32_t ColonnesBatiments::ajouter(Batiment *batiment) {
+  Resources consommation = batiment->getconsommation();
+  batiments.push_back(batiment);
+  eau.push_back(consommation.eau);
+  electricite.push_back(consommation.electricite);
+  pollution.push_back(traitsDe(batiment->type).pollution);
+  habitants.push_back(0.0);
+  capacite.push_back(0.0);
+  revenusComplets.push_back(0.0);
+  revenusPartiels.push_back(0.0);
+  return static_cast<uint32_t>(batiments.size() - 1);
+}
+
+Batiment *ColonnesBatiments::retirer(uint32_t ligne) {
+  size_t derniere = batiments.size() - 1;
+  Batiment *deplace = nullptr;
+  if (ligne != derniere) {
+    deplace = batiments[ligne] = batiments[derniere];
+    eau[ligne] = eau[derniere];
+    electricite[ligne] = electricite[derniere];
+    pollution[ligne] = pollution[derniere];
+    habitants[ligne] = habitants[derniere];
+    capacite[ligne] = capacite[derniere];
+    revenusComplets[ligne] = revenusComplets[derniere];
+    revenusPartiels[ligne] = revenusPartiels[derniere];
+  }
+  batiments.pop_back();
+  eau.pop_back();
+  electricite.pop_back();
+  pollution.pop_back();
+  habitants.pop_back();
+  capacite.pop_back();
+  revenusComplets.pop_back();
+  revenusPartiels.pop_back();
+  return deplace;
+}
+
+size_t ColonnesBatiments::taille() const { return batiments.size(); }
+
+void ColonnesBatiments::setHabitants(uint32_t ligne, int nombre,
+                                     int maximum) {
+  habitants[ligne] = nombre;
+  capacite[ligne] = maximum;
+}
+
+void ColonnesBatiments::setRevenu(uint32_t ligne, double revenu,
+                                  bool complet) {
+  revenusComplets[ligne] = complet ? revenu : 0.0;
+  revenusPartiels[ligne] = complet ? 0.0 : revenu;
+}
+
+void ColonnesBatiments::setComplet(uint32_t ligne, bool complet) {
+  setRevenu(ligne, revenusComplets[ligne] + revenusPartiels[ligne], complet);
+}
+
+Resources ColonnesBatiments::sommeConsommation() const {
+  return Resources(sommer(eau), sommer(electricite));
+}
+
+double ColonnesBatiments::sommePollution() const { return sommer(pollution); }
+
+double ColonnesBatiments::sommeOccupation() const {
+  return sommerRapports(habitants, capacite);
+}
+
+double ColonnesBatiments::sommeRevenus(double efficacite) const {
+  return sommer(revenusComplets) + efficacite * sommer(revenusPartiels);
+}
+
+const char *ColonnesBatiments::getJeuInstructions() { return noyaux()->nom; }
+
+bool ColonnesBatiments::choisirJeuInstructions(const char *nom) {
+  for (const Noyaux &n : NOYAUX)
+    if (std::strcmp(n.nom, nom) == 0 && disponible(nom)) {
+      noyaux() = &n;
+      return true;
+    }
+  return false;
+}
@@ -0,0 +1,19 @@
+#include "../include/cycle/commandes.hpp"
+
+bool FileCommandes::pousser(const Commande &commande) {
+  std::size_t ecriture = queue.load(std::memory_order_relaxed);
+  if (ecriture - tete.load(std::memory_order_acquire) == CAPACITE)
+    return false;
+  tampon[ecriture % CAPACITE] = commande;
+  queue.store(ecriture + 1, std::memory_order_release);
+  return true;
+}
+
+bool FileCommandes::extraire(Commande &commande) {
+  std::size_t lecture = tete.load(std::memory_order_relaxed);
+  if (lecture == queue.load(std::memory_order_acquire))
+    return false;
+  commande = tampon[lecture % CAPACITE];
+  tete.store(lecture + 1, std::memory_order_release);
+  return true;
+}
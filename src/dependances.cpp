@@ -0,0 +1,36 @@
+#include "../include/ville/dependances.hpp"
+
+void SuiviDependances::declarer(Derivee derivee,
+                                std::initializer_list<Entree> entrees) {
+  Etat &etat = derivees[static_cast<size_t>(derivee)];
+  etat.entrees = 0;
+  for (Entree entree : entrees)
+    etat.entrees |= 1u << static_cast<int>(entree);
+  etat.calculee = false;
+}
+
+void SuiviDependances::signaler(Entree entree) {
+  versions[static_cast<size_t>(entree)].fetch_add(1,
+                                                  std::memory_order_relaxed);
+}
+
+bool SuiviDependances::aRecalculer(Derivee derivee) {
+  Etat &etat = derivees[static_cast<size_t>(derivee)];
+  uint64_t actuelle = signature(etat.entrees);
+  if (actif && etat.calculee && actuelle == etat.signature)
+    return false;
+  etat.signature = actuelle;
+  etat.calculee = true;
+  return true;
+}
+
+void SuiviDependances::setActif(bool actif) { this->actif = actif; }
+
+// Versions only grow, so their sum changes whenever one of them does
+uint64_t SuiviDependances::signature(uint32_t entrees) const {
+  uint64_t somme = 0;
+  for (int i = 0; i < NOMBRE_ENTREES; ++i)
+    if (entrees & (1u << i))
+      somme += versions[i].load(std::memory_order_relaxed);
+  return somme;
+}
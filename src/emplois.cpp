@@ -0,0 +1,229 @@
+#include "../include/ville/emplois.hpp"
+#include "../include/buildings/service.hpp"
+#include <algorithm>
+
+// Position ka of a against position kb of b: a.postes / (ka - 1/2) compared
+// to b.postes / (kb - 1/2) without dividing
+bool RepartitionEmplois::mieux(const Part &a, unsigned int ka, const Part &b,
+                               unsigned int kb) {
+  unsigned long long gaucheA =
+      static_cast<unsigned long long>(a.postes) * (2ull * kb - 1);
+  unsigned long long droiteB =
+      static_cast<unsigned long long>(b.postes) * (2ull * ka - 1);
+  if (gaucheA != droiteB)
+    return gaucheA > droiteB;
+  return a.ordre < b.ordre;
+}
+
+// Open positions: the best next one first. Staffed: the worst last one first
+bool RepartitionEmplois::avant(const std::vector<Part *> &tas, size_t a,
+                               size_t b) const {
+  const Part &pa = *tas[a];
+  const Part &pb = *tas[b];
+  if (&tas == &ouverts)
+    return mieux(pa, pa.occupes + 1, pb, pb.occupes + 1);
+  return mieux(pb, pb.occupes, pa, pa.occupes);
+}
+
+size_t &RepartitionEmplois::indexDans(const std::vector<Part *> &tas,
+                                      Part *p) const {
+  return &tas == &ouverts ? p->indexOuverts : p->indexPourvus;
+}
+
+void RepartitionEmplois::placer(std::vector<Part *> &tas, size_t i, Part *p) {
+  tas[i] = p;
+  indexDans(tas, p) = i;
+}
+
+void RepartitionEmplois::monter(std::vector<Part *> &tas, size_t i) {
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (!avant(tas, i, parent))
+      break;
+    Part *p = tas[parent];
+    placer(tas, parent, tas[i]);
+    placer(tas, i, p);
+    i = parent;
+  }
+}
+
+void RepartitionEmplois::descendre(std::vector<Part *> &tas, size_t i) {
+  for (;;) {
+    size_t premier = i;
+    size_t gauche = 2 * i + 1, droite = gauche + 1;
+    if (gauche < tas.size() && avant(tas, gauche, premier))
+      premier = gauche;
+    if (droite < tas.size() && avant(tas, droite, premier))
+      premier = droite;
+    if (premier == i)
+      return;
+    Part *p = tas[premier];
+    placer(tas, premier, tas[i]);
+    placer(tas, i, p);
+    i = premier;
+  }
+}
+
+void RepartitionEmplois::inserer(std::vector<Part *> &tas, Part *p) {
+  tas.push_back(p);
+  indexDans(tas, p) = tas.size() - 1;
+  monter(tas, tas.size() - 1);
+}
+
+void RepartitionEmplois::enlever(std::vector<Part *> &tas, Part *p) {
+  size_t i = indexDans(tas, p);
+  indexDans(tas, p) = AUCUN;
+  Part *dernier = tas.back();
+  tas.pop_back();
+  if (i == tas.size())
+    return;
+  placer(tas, i, dernier);
+  monter(tas, i);
+  descendre(tas, indexDans(tas, dernier));
+}
+
+// An employer sits in ouverts while it has open jobs and in pourvus while
+// it has staff, keyed on its current share
+void RepartitionEmplois::actualiser(Part *p) {
+  bool ouvert = p->occupes < p->postes;
+  if (!ouvert && p->indexOuverts != AUCUN)
+    enlever(ouverts, p);
+  else if (ouvert && p->indexOuverts == AUCUN)
+    inserer(ouverts, p);
+  else if (ouvert) {
+    monter(ouverts, p->indexOuverts);
+    descendre(ouverts, p->indexOuverts);
+  }
+
+  bool pourvu = p->occupes > 0;
+  if (!pourvu && p->indexPourvus != AUCUN)
+    enlever(pourvus, p);
+  else if (pourvu && p->indexPourvus == AUCUN)
+    inserer(pourvus, p);
+  else if (pourvu) {
+    monter(pourvus, p->indexPourvus);
+    descendre(pourvus, p->indexPourvus);
+  }
+}
+
+void RepartitionEmplois::toucher(Part *p) {
+  if (p->indexTouches != AUCUN)
+    return;
+  p->indexTouches = touches.size();
+  touches.push_back(p);
+}
+
+void RepartitionEmplois::donner() {
+  Part *p = ouverts.front();
+  ++p->occupes;
+  ++places;
+  actualiser(p);
+  toucher(p);
+}
+
+void RepartitionEmplois::prendre() {
+  Part *p = pourvus.front();
+  --p->occupes;
+  --places;
+  actualiser(p);
+  toucher(p);
+}
+
+void RepartitionEmplois::ajouter(Service *s) {
+  auto [it, nouveau] = parts.try_emplace(s);
+  if (!nouveau)
+    return;
+  Part *p = &it->second;
+  p->service = s;
+  p->postes = s->getEmployeesNeeded();
+  p->occupes = 0;
+  p->ordre = prochainOrdre++;
+  postes += p->postes;
+  ++changements;
+  actualiser(p);
+  toucher(p);
+}
+
+void RepartitionEmplois::retirer(Service *s) {
+  auto it = parts.find(s);
+  if (it == parts.end())
+    return;
+  Part *p = &it->second;
+  if (p->indexOuverts != AUCUN)
+    enlever(ouverts, p);
+  if (p->indexPourvus != AUCUN)
+    enlever(pourvus, p);
+  if (p->indexTouches != AUCUN) {
+    Part *dernier = touches.back();
+    touches[p->indexTouches] = dernier;
+    dernier->indexTouches = p->indexTouches;
+    touches.pop_back();
+  }
+  places -= p->occupes;
+  postes -= p->postes;
+  ++changements;
+  parts.erase(it);
+}
+
+void RepartitionEmplois::invalider() { valide = false; }
+
+// Start from the proportional floors, which leave fewer than one position
+// per employer to hand out
+void RepartitionEmplois::reconstruire(unsigned long long cible) {
+  ouverts.clear();
+  pourvus.clear();
+  places = 0;
+  for (auto &[service, part] : parts) {
+    part.occupes = postes == 0 ? 0
+                               : static_cast<unsigned int>(
+                                     cible * part.postes / postes);
+    places += part.occupes;
+    part.indexOuverts = AUCUN;
+    part.indexPourvus = AUCUN;
+    if (part.occupes < part.postes) {
+      part.indexOuverts = ouverts.size();
+      ouverts.push_back(&part);
+    }
+    if (part.occupes > 0) {
+      part.indexPourvus = pourvus.size();
+      pourvus.push_back(&part);
+    }
+    toucher(&part);
+  }
+  for (size_t i = ouverts.size() / 2; i-- > 0;)
+    descendre(ouverts, i);
+  for (size_t i = pourvus.size() / 2; i-- > 0;)
+    descendre(pourvus, i);
+  valide = true;
+}
+
+void RepartitionEmplois::repartir(unsigned int travailleurs,
+                                  const Affectation &affecter) {
+  unsigned long long cible = std::min<unsigned long long>(travailleurs, postes);
+  unsigned long long ecart = cible > places ? cible - places : places - cible;
+  // Starting over is linear in the employers, moving workers one by one is
+  // not once too much changed at once
+  if (!valide || changements + ecart > parts.size())
+    reconstruire(cible);
+  changements = 0;
+
+  while (places < cible)
+    donner();
+  while (places > cible)
+    prendre();
+  // A worker moves while the best open position outweighs the worst
+  // staffed one
+  while (!ouverts.empty() && !pourvus.empty() &&
+         mieux(*ouverts.front(), ouverts.front()->occupes + 1,
+               *pourvus.front(), pourvus.front()->occupes)) {
+    prendre();
+    donner();
+  }
+
+  for (Part *p : touches) {
+    p->indexTouches = AUCUN;
+    if (p->service->getEmployees() != p->occupes)
+      affecter(p->service, p->occupes);
+  }
+  touches.clear();
+}
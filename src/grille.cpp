@@ -0,0 +1,157 @@
+#include "../include/ville/grille.hpp"
+#include "../include/buildings/batiment.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+GrilleSpatiale::GrilleSpatiale(int tailleCellule)
+    : tailleCellule(std::max(1, tailleCellule)) {}
+
+int GrilleSpatiale::coordCellule(int tuile) const {
+  // Floor division so negative coordinates land in their own cells
+  return tuile >= 0 ? tuile / tailleCellule
+                    : -((-tuile + tailleCellule - 1) / tailleCellule);
+}
+
+long long GrilleSpatiale::cle(int cx, int cy) {
+  return (static_cast<long long>(cx) << 32) |
+         static_cast<std::uint32_t>(cy);
+}
+
+long long GrilleSpatiale::cleCellule(Position position) const {
+  return cle(coordCellule(position.x), coordCellule(position.y));
+}
+
+void GrilleSpatiale::inserer(Batiment *batiment) {
+  cellules[cleCellule(batiment->position)].push_back(batiment);
+}
+
+void GrilleSpatiale::retirer(Batiment *batiment) {
+  auto it = cellules.find(cleCellule(batiment->position));
+  if (it == cellules.end())
+    return;
+  auto &contenu = it->second;
+  auto pos = std::find(contenu.begin(), contenu.end(), batiment);
+  if (pos == contenu.end())
+    return;
+  *pos = contenu.back();
+  contenu.pop_back();
+  if (contenu.empty())
+    cellules.erase(it);
+}
+
+void GrilleSpatiale::vider() { cellules.clear(); }
+
+void GrilleSpatiale::plusProches(
+    Position origine, size_t k, int distanceMax,
+    std::vector<std::pair<int, Batiment *>> &resultat) const {
+  resultat.clear();
+  if (k == 0 || distanceMax < 0 || cellules.empty())
+    return;
+
+  auto avant = [](const std::pair<int, Batiment *> &a,
+                  const std::pair<int, Batiment *> &b) {
+    if (a.first != b.first)
+      return a.first < b.first;
+    if (a.second->position.x != b.second->position.x)
+      return a.second->position.x < b.second->position.x;
+    return a.second->position.y < b.second->position.y;
+  };
+
+  auto visiter = [&](int cx, int cy) {
+    auto it = cellules.find(cle(cx, cy));
+    if (it == cellules.end())
+      return;
+    for (Batiment *batiment : it->second) {
+      int distance = std::abs(batiment->position.x - origine.x) +
+                     std::abs(batiment->position.y - origine.y);
+      if (distance <= distanceMax)
+        resultat.emplace_back(distance, batiment);
+    }
+  };
+
+  int ox = coordCellule(origine.x);
+  int oy = coordCellule(origine.y);
+  int rayonMax = distanceMax / tailleCellule + 1;
+
+  for (int r = 0; r <= rayonMax; ++r) {
+    // Closest any tile of ring r can be from the origin
+    int borne = r == 0 ? 0 : (r - 1) * tailleCellule + 1;
+    if (borne > distanceMax)
+      break;
+    if (resultat.size() >= k && borne > resultat[k - 1].first)
+      break;
+
+    if (r == 0) {
+      visiter(ox, oy);
+    } else {
+      for (int dx = -r; dx <= r; ++dx) {
+        visiter(ox + dx, oy - r);
+        visiter(ox + dx, oy + r);
+      }
+      for (int dy = -r + 1; dy <= r - 1; ++dy) {
+        visiter(ox - r, oy + dy);
+        visiter(ox + r, oy + dy);
+      }
+    }
+
+    if (resultat.size() >= k) {
+      std::nth_element(resultat.begin(), resultat.begin() + (k - 1),
+                       resultat.end(), avant);
+      resultat.resize(k);
+      // Keep the current k-th best last for the termination test
+      std::iter_swap(resultat.begin() + (k - 1),
+                     std::max_element(resultat.begin(), resultat.end(), avant));
+    }
+  }
+  std::sort(resultat.begin(), resultat.end(), avant);
+}
+
+void GrilleSpatiale::dansRayon(Position origine, int distance,
+                               std::vector<Batiment *> &resultat) const {
+  resultat.clear();
+  int cx0 = coordCellule(origine.x - distance);
+  int cx1 = coordCellule(origine.x + distance);
+  int cy0 = coordCellule(origine.y - distance);
+  int cy1 = coordCellule(origine.y + distance);
+  for (int cy = cy0; cy <= cy1; ++cy)
+    for (int cx = cx0; cx <= cx1; ++cx) {
+      auto it = cellules.find(cle(cx, cy));
+      if (it == cellules.end())
+        continue;
+      for (Batiment *batiment : it->second)
+        if (std::abs(batiment->position.x - origine.x) <= distance &&
+            std::abs(batiment->position.y - origine.y) <= distance)
+          resultat.push_back(batiment);
+    }
+}
+
+const std::vector<Batiment *> *GrilleSpatiale::cellule(long long cle) const {
+  auto it = cellules.find(cle);
+  return it == cellules.end() ? nullptr : &it->second;
+}
+
+std::vector<long long> GrilleSpatiale::cellulesVoisines(Position position,
+                                                        int distance) const {
+  std::vector<long long> voisines;
+  int ox = coordCellule(position.x);
+  int oy = coordCellule(position.y);
+  int rayon = distance / tailleCellule + 1;
+  for (int dy = -rayon; dy <= rayon; ++dy)
+    for (int dx = -rayon; dx <= rayon; ++dx) {
+      long long c = cle(ox + dx, oy + dy);
+      if (cellules.count(c))
+        voisines.push_back(c);
+    }
+  return voisines;
+}
+
+std::vector<long long> GrilleSpatiale::cellulesOccupees() const {
+  std::vector<long long> cles;
+  cles.reserve(cellules.size());
+  for (const auto &[c, contenu] : cellules)
+    cles.push_back(c);
+  return cles;
+}
+
+int GrilleSpatiale::getTailleCellule() const { return tailleCellule; }
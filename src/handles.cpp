@@ -0,0 +1,48 @@
+#include "../include/ville/handles.hpp"
+
+int TableHandles::allouer(Batiment *batiment) {
+  uint32_t index;
+  if (!libres.empty()) {
+    index = libres.back();
+    libres.pop_back();
+  } else if (emplacements.size() < NOMBRE_INDEX) {
+    index = static_cast<uint32_t>(emplacements.size());
+    emplacements.emplace_back();
+  } else {
+    return 0;
+  }
+  Emplacement &e = emplacements[index];
+  e.batiment = batiment;
+  ++nombre;
+  return static_cast<int>(e.generation << BITS_INDEX | index);
+}
+
+void TableHandles::liberer(int id) {
+  if (!get(id))
+    return;
+  uint32_t index = indexDe(id);
+  Emplacement &e = emplacements[index];
+  e.batiment = nullptr;
+  --nombre;
+  if (e.generation < GENERATION_MAX) {
+    ++e.generation;
+    libres.push_back(index);
+  }
+}
+
+Batiment *TableHandles::get(int id) const {
+  if (id <= 0)
+    return nullptr;
+  uint32_t index = indexDe(id);
+  if (index >= emplacements.size())
+    return nullptr;
+  const Emplacement &e = emplacements[index];
+  return e.generation == static_cast<uint32_t>(id) >> BITS_INDEX ? e.batiment
+                                                                 : nullptr;
+}
+
+size_t TableHandles::getNombre() const { return nombre; }
+
+uint32_t TableHandles::indexDe(int id) {
+  return static_cast<uint32_t>(id) & (NOMBRE_INDEX - 1);
+}
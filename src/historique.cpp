@@ -0,0 +1,72 @@
+#include "../include/cycle/historique.hpp"
+#include <fstream>
+
+void Historique::enregistrer(const Releve &releve) {
+  ++nombreReleves;
+  ajouter(0, releve);
+}
+
+void Historique::ajouter(int niveau, const Releve &releve) {
+  Niveau &n = niveaux[niveau];
+  if (n.taille < CAPACITE) {
+    n.releves[(n.debut + n.taille) % CAPACITE] = releve;
+    ++n.taille;
+  } else {
+    n.releves[n.debut] = releve;
+    n.debut = (n.debut + 1) % CAPACITE;
+  }
+
+  if (niveau + 1 >= NIVEAUX)
+    return;
+  n.somme.budget += releve.budget;
+  n.somme.population += releve.population;
+  n.somme.satisfaction += releve.satisfaction;
+  n.somme.pollution += releve.pollution;
+  n.somme.chomage += releve.chomage;
+  if (releve.evenement >= 0)
+    n.somme.evenement = releve.evenement;
+  if (++n.cumules < FACTEUR)
+    return;
+
+  Releve moyenne = n.somme;
+  moyenne.cycle = releve.cycle;
+  moyenne.budget /= FACTEUR;
+  moyenne.population /= FACTEUR;
+  moyenne.satisfaction /= FACTEUR;
+  moyenne.pollution /= FACTEUR;
+  moyenne.chomage /= FACTEUR;
+  n.somme = Releve();
+  n.cumules = 0;
+  ajouter(niveau + 1, moyenne);
+}
+
+size_t Historique::taille(int niveau) const { return niveaux[niveau].taille; }
+
+const Releve &Historique::get(int niveau, size_t i) const {
+  const Niveau &n = niveaux[niveau];
+  return n.releves[(n.debut + i) % CAPACITE];
+}
+
+int Historique::getPeriode(int niveau) const {
+  int periode = 1;
+  for (int i = 0; i < niveau; ++i)
+    periode *= FACTEUR;
+  return periode;
+}
+
+unsigned long Historique::getNombreReleves() const { return nombreReleves; }
+
+bool Historique::exporterCSV(const std::string &chemin, int niveau) const {
+  std::ofstream fichier(chemin);
+  if (!fichier.is_open())
+    return false;
+  fichier << "cycle,budget,population,satisfaction,pollution,unemployment,"
+             "event\n";
+  for (size_t i = 0; i < taille(niveau); ++i) {
+    const Releve &r = get(niveau, i);
+    fichier << r.cycle << ',' << r.budget << ',' << r.population << ','
+            << r.satisfaction << ',' << r.pollution << ',' << r.chomage << ','
+            << r.evenement << '\n';
+  }
+  return static_cast<bool>(fichier);
+}
@@ -0,0 +1,12 @@
+#include "../include/cycle/instantane.hpp"
+
+void TamponInstantanes::publier(std::shared_ptr<const Instantane> instantane) {
+  std::lock_guard<std::mutex> garde(verrou);
+  courant.swap(instantane);
+  // The previous snapshot is released outside the lock, with instantane
+}
+
+std::shared_ptr<const Instantane> TamponInstantanes::lire() const {
+  std::lock_guard<std::mutex> garde(verrou);
+  return courant;
+}
@@ -1,10 +1,20 @@
 #include <SDL2/SDL.h>
 #include "../include/application.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
 
 
-int main() {
+int main(int argc, char *argv[]) {
     WindowSettings settings{"Demo App"};
     Application app(settings);
+
+    // --metrics-port N serves the simulation metrics on 127.0.0.1:N
+    for (int i = 1; i + 1 < argc; ++i)
+        if (std::string(argv[i]) == "--metrics-port" &&
+            !app.sim.exposerMetriques(std::atoi(argv[i + 1])))
+            std::cerr << "Metrics endpoint unavailable on port "
+                      << argv[i + 1] << "\n";
+
     return app.run();
 }
-
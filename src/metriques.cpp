@@ -0,0 +1,163 @@
+#include "../include/cycle/metriques.hpp"
+#include <arpa/inet.h>
+#include <cstdio>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string_view>
+#include <sys/socket.h>
+#include <unistd.h>
+
+size_t RegistreMetriques::enregistrer(Genre genre, const std::string &nom,
+                                      const std::string &aide,
+                                      const std::string &etiquettes) {
+  size_t index = nombre.load(std::memory_order_relaxed);
+  if (index >= CAPACITE)
+    return CAPACITE;
+  Metrique &m = metriques[index];
+  m.genre = genre;
+  m.nom = nom;
+  m.aide = aide;
+  m.etiquettes = etiquettes;
+  m.valeur.store(0.0, std::memory_order_relaxed);
+  // Readers only look at entries below nombre, this publishes the strings
+  nombre.store(index + 1, std::memory_order_release);
+  return index;
+}
+
+void RegistreMetriques::ajouter(size_t metrique, double valeur) {
+  if (metrique < CAPACITE)
+    metriques[metrique].valeur.fetch_add(valeur, std::memory_order_relaxed);
+}
+
+void RegistreMetriques::fixer(size_t metrique, double valeur) {
+  if (metrique < CAPACITE)
+    metriques[metrique].valeur.store(valeur, std::memory_order_relaxed);
+}
+
+double RegistreMetriques::lire(size_t metrique) const {
+  return metrique < CAPACITE
+             ? metriques[metrique].valeur.load(std::memory_order_relaxed)
+             : 0.0;
+}
+
+size_t RegistreMetriques::taille() const {
+  return nombre.load(std::memory_order_acquire);
+}
+
+std::string RegistreMetriques::exporter() const {
+  std::string texte;
+  size_t n = taille();
+  char valeur[32];
+  for (size_t i = 0; i < n; ++i) {
+    const Metrique &m = metriques[i];
+    if (i == 0 || metriques[i - 1].nom != m.nom) {
+      texte += "# HELP " + m.nom + " " + m.aide + "\n";
+      texte += "# TYPE " + m.nom +
+               (m.genre == Genre::Compteur ? " counter\n" : " gauge\n");
+    }
+    texte += m.nom;
+    if (!m.etiquettes.empty())
+      texte += "{" + m.etiquettes + "}";
+    std::snprintf(valeur, sizeof(valeur), " %.12g\n",
+                  m.valeur.load(std::memory_order_relaxed));
+    texte += valeur;
+  }
+  return texte;
+}
+
+ServeurMetriques::ServeurMetriques(const RegistreMetriques &registre)
+    : registre(registre) {}
+
+ServeurMetriques::~ServeurMetriques() { arreter(); }
+
+bool ServeurMetriques::demarrer(unsigned short port) {
+  arreter();
+  socketEcoute = socket(AF_INET, SOCK_STREAM, 0);
+  if (socketEcoute < 0)
+    return false;
+  int oui = 1;
+  setsockopt(socketEcoute, SOL_SOCKET, SO_REUSEADDR, &oui, sizeof(oui));
+
+  sockaddr_in adresse{};
+  adresse.sin_family = AF_INET;
+  adresse.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  adresse.sin_port = htons(port);
+  socklen_t longueur = sizeof(adresse);
+  if (bind(socketEcoute, reinterpret_cast<sockaddr *>(&adresse),
+           sizeof(adresse)) != 0 ||
+      listen(socketEcoute, 8) != 0 ||
+      getsockname(socketEcoute, reinterpret_cast<sockaddr *>(&adresse),
+                  &longueur) != 0) {
+    close(socketEcoute);
+    socketEcoute = -1;
+    return false;
+  }
+  this->port = ntohs(adresse.sin_port);
+  actif = true;
+  fil = std::thread(&ServeurMetriques::boucle, this);
+  return true;
+}
+
+void ServeurMetriques::arreter() {
+  actif = false;
+  if (fil.joinable())
+    fil.join();
+  if (socketEcoute >= 0)
+    close(socketEcoute);
+  socketEcoute = -1;
+}
+
+unsigned short ServeurMetriques::getPort() const { return port; }
+
+// Wakes up regularly to notice arreter(), clients are served one at a time
+void ServeurMetriques::boucle() {
+  while (actif) {
+    pollfd attente{socketEcoute, POLLIN, 0};
+    if (poll(&attente, 1, 200) <= 0)
+      continue;
+    int client = accept(socketEcoute, nullptr, nullptr);
+    if (client < 0)
+      continue;
+    repondre(client);
+    close(client);
+  }
+}
+
+void ServeurMetriques::repondre(int client) const {
+  // The request line is enough, a slow client is dropped after a second
+  char requete[1024];
+  size_t lus = 0;
+  while (lus < sizeof(requete) - 1) {
+    pollfd attente{client, POLLIN, 0};
+    if (poll(&attente, 1, 1000) <= 0)
+      return;
+    ssize_t n = recv(client, requete + lus, sizeof(requete) - 1 - lus, 0);
+    if (n <= 0)
+      return;
+    lus += static_cast<size_t>(n);
+    requete[lus] = '\0';
+    if (std::string_view(requete, lus).find("\r\n") != std::string_view::npos)
+      break;
+  }
+  std::string_view ligne(requete, lus);
+
+  std::string corps;
+  std::string statut = "404 Not Found";
+  if (ligne.starts_with("GET /metrics ") || ligne.starts_with("GET / ")) {
+    corps = registre.exporter();
+    statut = "200 OK";
+  }
+  std::string reponse = "HTTP/1.1 " + statut +
+                        "\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                        "Content-Length: " +
+                        std::to_string(corps.size()) +
+                        "\r\nConnection: close\r\n\r\n" + corps;
+  size_t envoyes = 0;
+  while (envoyes < reponse.size()) {
+    ssize_t n = send(client, reponse.data() + envoyes,
+                     reponse.size() - envoyes, MSG_NOSIGNAL);
+    if (n <= 0)
+      return;
+    envoyes += static_cast<size_t>(n);
+  }
+}
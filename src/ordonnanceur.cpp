@@ -0,0 +1,183 @@
+#include "../include/cycle/ordonnanceur.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+// Queue owned by the current thread, none for threads outside the pool
+thread_local PoolTravail *poolCourant = nullptr;
+thread_local size_t indexCourant = 0;
+} // namespace
+
+PoolTravail &PoolTravail::instance() {
+  // The calling thread always helps, so one worker less than cores
+  static PoolTravail pool(std::max(1u, std::thread::hardware_concurrency()) -
+                          1);
+  return pool;
+}
+
+PoolTravail::PoolTravail(unsigned int nombreThreads) {
+  for (unsigned int i = 0; i <= nombreThreads; ++i)
+    files.push_back(std::make_unique<File>());
+  threads.reserve(nombreThreads);
+  for (unsigned int i = 0; i < nombreThreads; ++i)
+    threads.emplace_back([this, i]() { boucle(i); });
+}
+
+PoolTravail::~PoolTravail() {
+  {
+    std::lock_guard<std::mutex> verrou(verrouReveil);
+    arret = true;
+  }
+  reveil.notify_all();
+  for (auto &thread : threads)
+    thread.join();
+}
+
+unsigned int PoolTravail::getNombreThreads() const {
+  return static_cast<unsigned int>(threads.size());
+}
+
+size_t PoolTravail::fileCourante() const {
+  return poolCourant == this ? indexCourant : files.size() - 1;
+}
+
+void PoolTravail::soumettre(std::function<void()> tache) {
+  {
+    std::lock_guard<std::mutex> verrou(verrouReveil);
+    ++enAttente; // counted first so it never goes below zero
+  }
+  {
+    File &file = *files[fileCourante()];
+    std::lock_guard<std::mutex> verrou(file.verrou);
+    file.taches.push_back(std::move(tache));
+  }
+  reveil.notify_one();
+  reveillerAidants();
+}
+
+// Waiters check their condition under verrouReveil, so taking it before
+// notifying cannot miss one about to sleep
+void PoolTravail::reveillerAidants() {
+  {
+    std::lock_guard<std::mutex> verrou(verrouReveil);
+    if (aidants == 0)
+      return;
+  }
+  fin.notify_all();
+}
+
+// Newest task of our own queue, else the oldest one of another queue
+bool PoolTravail::executerUne(size_t index) {
+  std::function<void()> tache;
+  {
+    File &file = *files[index];
+    std::lock_guard<std::mutex> verrou(file.verrou);
+    if (!file.taches.empty()) {
+      tache = std::move(file.taches.back());
+      file.taches.pop_back();
+    }
+  }
+  for (size_t i = 1; !tache && i < files.size(); ++i) {
+    File &file = *files[(index + i) % files.size()];
+    std::lock_guard<std::mutex> verrou(file.verrou);
+    if (!file.taches.empty()) {
+      tache = std::move(file.taches.front());
+      file.taches.pop_front();
+    }
+  }
+  if (!tache)
+    return false;
+  --enAttente;
+  tache();
+  reveillerAidants();
+  return true;
+}
+
+void PoolTravail::boucle(size_t index) {
+  poolCourant = this;
+  indexCourant = index;
+  while (true) {
+    if (executerUne(index))
+      continue;
+    std::unique_lock<std::mutex> verrou(verrouReveil);
+    reveil.wait(verrou, [this]() { return arret || enAttente > 0; });
+    if (arret)
+      return;
+  }
+}
+
+void PoolTravail::aiderJusqua(const std::function<bool()> &termine) {
+  size_t index = fileCourante();
+  while (!termine()) {
+    if (executerUne(index))
+      continue;
+    std::unique_lock<std::mutex> verrou(verrouReveil);
+    ++aidants;
+    fin.wait(verrou,
+             [&]() { return arret || enAttente > 0 || termine(); });
+    --aidants;
+  }
+}
+
+int GrapheTaches::ajouter(const std::string &nom, std::function<void()> tache,
+                          std::initializer_list<int> dependances) {
+  int id = static_cast<int>(phases.size());
+  Phase phase;
+  phase.nom = nom;
+  phase.tache = std::move(tache);
+  for (int dependance : dependances)
+    if (dependance < 0 || dependance >= id)
+      throw std::invalid_argument("phase " + nom +
+                                  " depends on a phase not added before it");
+  for (int dependance : dependances) {
+    phases[dependance].suivantes.push_back(id);
+    ++phase.dependances;
+  }
+  phases.push_back(std::move(phase));
+  return id;
+}
+
+void GrapheTaches::executer(bool parallele) {
+  auto chronometrer = [this](int id) {
+    auto debut = std::chrono::steady_clock::now();
+    phases[id].tache();
+    phases[id].duree = std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - debut)
+                           .count();
+  };
+
+  if (!parallele) {
+    for (int id = 0; id < static_cast<int>(phases.size()); ++id)
+      chronometrer(id);
+    return;
+  }
+
+  PoolTravail &pool = PoolTravail::instance();
+  auto restantes = std::make_unique<std::atomic<int>[]>(phases.size());
+  for (size_t id = 0; id < phases.size(); ++id)
+    restantes[id] = phases[id].dependances;
+  std::atomic<size_t> terminees{0};
+
+  std::function<void(int)> lancer = [&](int id) {
+    pool.soumettre([&, id]() {
+      chronometrer(id);
+      for (int suivante : phases[id].suivantes)
+        if (--restantes[suivante] == 0)
+          lancer(suivante);
+      ++terminees; // last access to this frame
+    });
+  };
+  for (int id = 0; id < static_cast<int>(phases.size()); ++id)
+    if (phases[id].dependances == 0)
+      lancer(id);
+  pool.aiderJusqua([&]() { return terminees == phases.size(); });
+}
+
+size_t GrapheTaches::taille() const { return phases.size(); }
+
+const std::string &GrapheTaches::getNom(int phase) const {
+  return phases[phase].nom;
+}
+
+double GrapheTaches::getDuree(int phase) const { return phases[phase].duree; }
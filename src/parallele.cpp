@@ -0,0 +1,30 @@
+#include "../include/cycle/parallele.hpp"
+#include "../include/cycle/ordonnanceur.hpp"
+#include <algorithm>
+#include <atomic>
+
+void executerEnParallele(std::size_t nombre,
+                         const std::function<void(std::size_t)> &tache) {
+  PoolTravail &pool = PoolTravail::instance();
+  std::size_t parts =
+      std::min<std::size_t>(pool.getNombreThreads() + 1, nombre);
+  if (parts <= 1) {
+    for (std::size_t i = 0; i < nombre; ++i)
+      tache(i);
+    return;
+  }
+
+  // Tasks are handed out one at a time so uneven regions balance out
+  std::atomic<std::size_t> suivante{0};
+  std::atomic<std::size_t> actives{parts};
+  auto travailleur = [&]() {
+    for (std::size_t i = suivante++; i < nombre; i = suivante++)
+      tache(i);
+    --actives; // last access to this frame
+  };
+
+  for (std::size_t p = 1; p < parts; ++p)
+    pool.soumettre(travailleur);
+  travailleur();
+  pool.aiderJusqua([&]() { return actives == 0; });
+}
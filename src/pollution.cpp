@@ -0,0 +1,274 @@
+#include "../include/ville/pollution.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POLLUTION_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// One row of the stencil, every pointer at x = 0 of the row
+struct Ligne {
+  const float *c, *n, *s, *em, *cons;
+  float *out;
+  int largeur;
+  float diffusion;
+};
+
+// next = max(0, (c + d * (n + s + e + w - 4c)) * conservation + emission)
+// Every kernel computes it with the same operations in the same order, so
+// they give bit-identical fields
+void finirLigne(const Ligne &l, int x) {
+  for (; x < l.largeur; ++x) {
+    float voisins = (l.n[x] + l.s[x]) + (l.c[x - 1] + l.c[x + 1]);
+    float lap = voisins - 4.0f * l.c[x];
+    float v = (l.c[x] + l.diffusion * lap) * l.cons[x] + l.em[x];
+    l.out[x] = std::max(v, 0.0f);
+  }
+}
+
+void etapeLigneScalaire(const Ligne &l) { finirLigne(l, 0); }
+
+#if defined(__SSE2__)
+void etapeLigneSse2(const Ligne &l) {
+  const __m128 vd = _mm_set1_ps(l.diffusion);
+  const __m128 v4 = _mm_set1_ps(4.0f);
+  const __m128 vzero = _mm_setzero_ps();
+  int x = 0;
+  for (; x + 4 <= l.largeur; x += 4) {
+    __m128 vc = _mm_loadu_ps(l.c + x);
+    __m128 voisins = _mm_add_ps(
+        _mm_add_ps(_mm_loadu_ps(l.n + x), _mm_loadu_ps(l.s + x)),
+        _mm_add_ps(_mm_loadu_ps(l.c + x - 1), _mm_loadu_ps(l.c + x + 1)));
+    __m128 lap = _mm_sub_ps(voisins, _mm_mul_ps(v4, vc));
+    __m128 v = _mm_add_ps(vc, _mm_mul_ps(vd, lap));
+    v = _mm_add_ps(_mm_mul_ps(v, _mm_loadu_ps(l.cons + x)),
+                   _mm_loadu_ps(l.em + x));
+    _mm_storeu_ps(l.out + x, _mm_max_ps(v, vzero));
+  }
+  finirLigne(l, x);
+}
+#endif
+
+#ifdef POLLUTION_AVX
+__attribute__((target("avx"))) void etapeLigneAvx(const Ligne &l) {
+  const __m256 vd = _mm256_set1_ps(l.diffusion);
+  const __m256 v4 = _mm256_set1_ps(4.0f);
+  const __m256 vzero = _mm256_setzero_ps();
+  int x = 0;
+  for (; x + 8 <= l.largeur; x += 8) {
+    __m256 vc = _mm256_loadu_ps(l.c + x);
+    __m256 voisins = _mm256_add_ps(
+        _mm256_add_ps(_mm256_loadu_ps(l.n + x), _mm256_loadu_ps(l.s + x)),
+        _mm256_add_ps(_mm256_loadu_ps(l.c + x - 1),
+                      _mm256_loadu_ps(l.c + x + 1)));
+    __m256 lap = _mm256_sub_ps(voisins, _mm256_mul_ps(v4, vc));
+    __m256 v = _mm256_add_ps(vc, _mm256_mul_ps(vd, lap));
+    v = _mm256_add_ps(_mm256_mul_ps(v, _mm256_loadu_ps(l.cons + x)),
+                      _mm256_loadu_ps(l.em + x));
+    _mm256_storeu_ps(l.out + x, _mm256_max_ps(v, vzero));
+  }
+  finirLigne(l, x);
+}
+#endif
+
+struct Noyau {
+  void (*etapeLigne)(const Ligne &);
+  const char *nom;
+};
+
+// Whether this processor runs the kernel called nom
+bool disponible(const char *nom) {
+#ifdef POLLUTION_AVX
+  __builtin_cpu_init();
+  if (std::strcmp(nom, "avx") == 0)
+    return __builtin_cpu_supports("avx");
+#endif
+#if defined(__SSE2__)
+  if (std::strcmp(nom, "sse2") == 0)
+    return true;
+#endif
+  return std::strcmp(nom, "scalar") == 0;
+}
+
+const Noyau NOYAUX[] = { // widest first
+#ifdef POLLUTION_AVX
+    {etapeLigneAvx, "avx"},
+#endif
+#if defined(__SSE2__)
+    {etapeLigneSse2, "sse2"},
+#endif
+    {etapeLigneScalaire, "scalar"},
+};
+
+// Picked once, the widest kernel available
+const Noyau *&noyau() {
+  static const Noyau *choisi = [] {
+    for (const Noyau &n : NOYAUX)
+      if (disponible(n.nom))
+        return &n;
+    return &NOYAUX[std::size(NOYAUX) - 1];
+  }();
+  return choisi;
+}
+
+} // namespace
+
+float ChampPollution::DIFFUSION = 0.15f;
+float ChampPollution::DECROISSANCE = 0.02f;
+
+ChampPollution::ChampPollution(int largeur, int hauteur) {
+  redimensionner(largeur, hauteur);
+}
+
+void ChampPollution::redimensionner(int largeur, int hauteur) {
+  this->largeur = std::max(0, largeur);
+  this->hauteur = std::max(0, hauteur);
+  pas = (this->largeur + 2 + 7) / 8 * 8;
+  size_t taille = static_cast<size_t>(pas) * (this->hauteur + 2);
+  courant.assign(taille, 0.0f);
+  suivant.assign(taille, 0.0f);
+  emission.assign(taille, 0.0f);
+  retenue.assign(taille, 0.0f);
+  conservation.assign(taille, 0.0f);
+  reinitialiserSources();
+}
+
+size_t ChampPollution::index(int x, int y) const {
+  return static_cast<size_t>(y + 1) * pas + (x + 1);
+}
+
+void ChampPollution::reinitialiserSources() {
+  stable = false;
+  std::fill(emission.begin(), emission.end(), 0.0f);
+  std::fill(retenue.begin(), retenue.end(), 0.0f);
+  for (int y = 0; y < hauteur; ++y)
+    std::fill_n(retenue.begin() + index(0, y), largeur, 1.0f);
+  calculerConservation();
+}
+
+// The border keeps nothing, so pollution leaks out at the edges
+void ChampPollution::calculerConservation() {
+  stable = false;
+  decroissance = DECROISSANCE;
+  float garde = 1.0f - std::clamp(decroissance, 0.0f, 1.0f);
+  for (size_t i = 0; i < retenue.size(); ++i)
+    conservation[i] = retenue[i] * garde;
+}
+
+// Footprint spans surface.longeur tiles along x and surface.largeur along y
+void ChampPollution::ajouterSource(Position position, Surface surface,
+                                   float emissionTotale) {
+  stable = false;
+  int longeur = std::max(1, static_cast<int>(surface.longeur));
+  int larg = std::max(1, static_cast<int>(surface.largeur));
+  float parTuile = emissionTotale / static_cast<float>(longeur * larg);
+  for (int dy = 0; dy < larg; ++dy)
+    for (int dx = 0; dx < longeur; ++dx) {
+      int x = position.x + dx, y = position.y + dy;
+      if (x >= 0 && x < largeur && y >= 0 && y < hauteur)
+        emission[index(x, y)] += parTuile;
+    }
+}
+
+void ChampPollution::ajouterPuits(Position position, Surface surface,
+                                  float absorption) {
+  stable = false;
+  float garde = 1.0f - std::clamp(absorption, 0.0f, 1.0f);
+  int longeur = std::max(1, static_cast<int>(surface.longeur));
+  int larg = std::max(1, static_cast<int>(surface.largeur));
+  for (int dy = 0; dy < larg; ++dy)
+    for (int dx = 0; dx < longeur; ++dx) {
+      int x = position.x + dx, y = position.y + dy;
+      if (x >= 0 && x < largeur && y >= 0 && y < hauteur) {
+        retenue[index(x, y)] *= garde;
+        conservation[index(x, y)] *= garde;
+      }
+    }
+}
+
+void ChampPollution::etapeLigne(int y, float diffusion) {
+  size_t debut = index(0, y);
+  const float *c = courant.data() + debut;
+  Ligne ligne{c,
+              c - pas,
+              c + pas,
+              emission.data() + debut,
+              conservation.data() + debut,
+              suivant.data() + debut,
+              largeur,
+              diffusion};
+  noyau()->etapeLigne(ligne);
+}
+
+void ChampPollution::etape() {
+  float diffusion = std::clamp(DIFFUSION, 0.0f, 0.25f);
+  for (int y = 0; y < hauteur; ++y)
+    etapeLigne(y, diffusion);
+  courant.swap(suivant);
+}
+
+// Once a step leaves the field unchanged it has settled, further steps
+// are skipped until the sources, the diffusion or the decay change
+bool ChampPollution::simuler(int etapes) {
+  if (decroissance != DECROISSANCE)
+    calculerConservation();
+  if (stable && diffusionStable == DIFFUSION)
+    return false;
+  for (int i = 0; i < etapes; ++i)
+    etape();
+  stable = etapes > 0 && courant == suivant;
+  diffusionStable = DIFFUSION;
+  return etapes > 0;
+}
+
+float ChampPollution::valeur(int x, int y) const {
+  if (x < 0 || x >= largeur || y < 0 || y >= hauteur)
+    return 0.0f;
+  return courant[index(x, y)];
+}
+
+float ChampPollution::moyenne() const {
+  if (largeur == 0 || hauteur == 0)
+    return 0.0f;
+  double somme = 0.0;
+  for (int y = 0; y < hauteur; ++y) {
+    const float *ligne = courant.data() + index(0, y);
+    for (int x = 0; x < largeur; ++x)
+      somme += ligne[x];
+  }
+  return static_cast<float>(somme / (static_cast<double>(largeur) * hauteur));
+}
+
+float ChampPollution::moyenneSources() const {
+  double somme = 0.0;
+  double poids = 0.0;
+  for (int y = 0; y < hauteur; ++y) {
+    const float *ligne = courant.data() + index(0, y);
+    const float *em = emission.data() + index(0, y);
+    for (int x = 0; x < largeur; ++x) {
+      somme += static_cast<double>(em[x]) * ligne[x];
+      poids += em[x];
+    }
+  }
+  return poids > 0.0 ? static_cast<float>(somme / poids) : 0.0f;
+}
+
+const char *ChampPollution::getJeuInstructions() { return noyau()->nom; }
+
+bool ChampPollution::choisirJeuInstructions(const char *nom) {
+  for (const Noyau &n : NOYAUX)
+    if (std::strcmp(n.nom, nom) == 0 && disponible(nom)) {
+      noyau() = &n;
+      return true;
+    }
+  return false;
+}
+
+int ChampPollution::getLargeur() const { return largeur; }
+int ChampPollution::getHauteur() const { return hauteur; }
@@ -0,0 +1,177 @@
+#include "../include/ville/reseau.hpp"
+#include "../include/buildings/infrastructure.hpp"
+#include "../include/buildings/traits.hpp"
+#include <algorithm>
+
+bool ReseauRessources::estCentrale(const Batiment &batiment) {
+  return traitsDe(batiment.type).centrale;
+}
+
+// Footprints cover surface.longeur tiles along x and surface.largeur along y
+bool ReseauRessources::raccordes(const Batiment &a, const Batiment &b) {
+  int ax1 = a.position.x + std::max(1, static_cast<int>(a.surface.longeur)) - 1;
+  int ay1 = a.position.y + std::max(1, static_cast<int>(a.surface.largeur)) - 1;
+  int bx1 = b.position.x + std::max(1, static_cast<int>(b.surface.longeur)) - 1;
+  int by1 = b.position.y + std::max(1, static_cast<int>(b.surface.largeur)) - 1;
+  int ecartX = std::max(0, std::max(a.position.x, b.position.x) -
+                               std::min(ax1, bx1) - 1);
+  int ecartY = std::max(0, std::max(a.position.y, b.position.y) -
+                               std::min(ay1, by1) - 1);
+  return std::max(ecartX, ecartY) <= PORTEE;
+}
+
+void ReseauRessources::ajouter(Batiment *batiment) {
+  if (noeuds.count(batiment))
+    return;
+  Noeud &noeud = noeuds[batiment];
+
+  // A neighbour's corner is at most PORTEE plus a footprint away
+  std::vector<Batiment *> proches;
+  grille.dansRayon(batiment->position, PORTEE + EMPRISE_MAX, proches);
+  for (Batiment *autre : proches) {
+    if (!raccordes(*batiment, *autre))
+      continue;
+    Noeud &voisin = noeuds.at(autre);
+    noeud.voisins.push_back(autre);
+    voisin.voisins.push_back(batiment);
+    if (voisin.composante >= 0)
+      composantesModifiees.insert(voisin.composante);
+  }
+
+  grille.inserer(batiment);
+  nouveaux.push_back(batiment);
+}
+
+void ReseauRessources::retirer(Batiment *batiment) {
+  auto it = noeuds.find(batiment);
+  if (it == noeuds.end())
+    return;
+
+  for (Batiment *autre : it->second.voisins) {
+    auto &voisins = noeuds.at(autre).voisins;
+    auto pos = std::find(voisins.begin(), voisins.end(), batiment);
+    if (pos != voisins.end()) {
+      *pos = voisins.back();
+      voisins.pop_back();
+    }
+  }
+  if (it->second.composante >= 0)
+    composantesModifiees.insert(it->second.composante);
+
+  grille.retirer(batiment);
+  noeuds.erase(it);
+}
+
+// Relabel only the components touched since the last rebuild
+void ReseauRessources::reconstruire() {
+  if (composantesModifiees.empty() && nouveaux.empty())
+    return;
+
+  // Buildings removed before their first rebuild left no node behind, and
+  // one re-added at the same address is only taken once
+  std::vector<Batiment *> aTraiter;
+  for (Batiment *batiment : nouveaux) {
+    auto noeud = noeuds.find(batiment);
+    if (noeud == noeuds.end() || !noeud->second.nouveau)
+      continue;
+    noeud->second.nouveau = false;
+    aTraiter.push_back(batiment);
+  }
+  nouveaux.clear();
+  for (int id : composantesModifiees) {
+    auto it = composantes.find(id);
+    if (it == composantes.end())
+      continue;
+    for (Batiment *membre : it->second.ordre)
+      if (noeuds.count(membre))
+        aTraiter.push_back(membre);
+    composantes.erase(it);
+  }
+  composantesModifiees.clear();
+
+  for (Batiment *batiment : aTraiter)
+    noeuds.at(batiment).composante = -1;
+
+  for (Batiment *depart : aTraiter) {
+    if (noeuds.at(depart).composante != -1)
+      continue;
+    int id = prochaineComposante++;
+    std::vector<Batiment *> membres{depart};
+    noeuds.at(depart).composante = id;
+    for (size_t i = 0; i < membres.size(); ++i)
+      for (Batiment *autre : noeuds.at(membres[i]).voisins) {
+        Noeud &voisin = noeuds.at(autre);
+        if (voisin.composante == -1) {
+          voisin.composante = id;
+          membres.push_back(autre);
+        }
+      }
+    ordonner(composantes[id], membres);
+  }
+}
+
+// Breadth-first from every plant of the component at once
+void ReseauRessources::ordonner(Composante &composante,
+                                const std::vector<Batiment *> &membres) {
+  composante.ordre.clear();
+  composante.centrales.clear();
+  std::unordered_set<Batiment *> vus;
+  for (Batiment *membre : membres)
+    if (estCentrale(*membre)) {
+      composante.ordre.push_back(membre);
+      composante.centrales.push_back(static_cast<Infrastructure *>(membre));
+      vus.insert(membre);
+    }
+  for (size_t i = 0; i < composante.ordre.size(); ++i)
+    for (Batiment *autre : noeuds.at(composante.ordre[i]).voisins)
+      if (vus.insert(autre).second)
+        composante.ordre.push_back(autre);
+  // Components without a plant get nothing, order does not matter
+  for (Batiment *membre : membres)
+    if (vus.insert(membre).second)
+      composante.ordre.push_back(membre);
+
+  for (size_t i = 0; i < composante.ordre.size(); ++i)
+    noeuds.at(composante.ordre[i]).rang = i;
+  composante.penuries.assign(composante.ordre.size(), Resources());
+}
+
+Resources ReseauRessources::distribuer() {
+  reconstruire();
+
+  production = demande = penurie = Resources();
+  Resources livre;
+  for (auto &[id, composante] : composantes) {
+    Resources stock;
+    for (Infrastructure *centrale : composante.centrales)
+      stock += centrale->getProductionEffective();
+    production += stock;
+
+    for (size_t i = 0; i < composante.ordre.size(); ++i) {
+      Resources besoin = composante.ordre[i]->getconsommation();
+      Resources servi(std::clamp(besoin.eau, 0.0, stock.eau),
+                      std::clamp(besoin.electricite, 0.0, stock.electricite));
+      stock -= servi;
+      livre += servi;
+      demande += besoin;
+      composante.penuries[i] = besoin - servi;
+      penurie += composante.penuries[i];
+    }
+  }
+  return livre;
+}
+
+Resources ReseauRessources::getProductionTotale() const { return production; }
+Resources ReseauRessources::getDemandeTotale() const { return demande; }
+Resources ReseauRessources::getPenurieTotale() const { return penurie; }
+
+Resources ReseauRessources::getPenurie(const Batiment *batiment) const {
+  auto noeud = noeuds.find(const_cast<Batiment *>(batiment));
+  if (noeud == noeuds.end())
+    return Resources();
+  auto composante = composantes.find(noeud->second.composante);
+  if (composante == composantes.end() ||
+      noeud->second.rang >= composante->second.penuries.size())
+    return Resources();
+  return composante->second.penuries[noeud->second.rang];
+}
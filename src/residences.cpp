@@ -0,0 +1,108 @@
+#include "../include/ville/residences.hpp"
+#include "../include/buildings/resident.hpp"
+#include <algorithm>
+
+void IndexResidences::inserer(std::vector<std::vector<Resident *>> &seaux,
+                              int seau, Resident *r, size_t &index) {
+  if (seau >= static_cast<int>(seaux.size()))
+    seaux.resize(seau + 1);
+  index = seaux[seau].size();
+  seaux[seau].push_back(r);
+}
+
+// Swap-remove from a bucket, fixing the index of the moved residence
+void IndexResidences::enlever(std::vector<std::vector<Resident *>> &seaux,
+                              int seau, size_t index, bool libre) {
+  auto &contenu = seaux[seau];
+  Resident *deplace = contenu.back();
+  contenu[index] = deplace;
+  contenu.pop_back();
+  if (index < contenu.size()) {
+    Place &place = places.at(deplace);
+    (libre ? place.indexLibre : place.indexOccupants) = index;
+  }
+}
+
+void IndexResidences::ajouter(Resident *r) {
+  if (places.count(r))
+    return;
+  Place place;
+  place.indexToutes = residences.size();
+  residences.push_back(r);
+  place.occupants = r->gethabitantsActuels();
+  place.libre = std::max(0, r->getcapaciteHabitants() - place.occupants);
+  inserer(parLibre, place.libre, r, place.indexLibre);
+  inserer(parOccupants, place.occupants, r, place.indexOccupants);
+  places.emplace(r, place);
+}
+
+void IndexResidences::retirer(Resident *r) {
+  auto it = places.find(r);
+  if (it == places.end())
+    return;
+  Place place = it->second;
+  enlever(parLibre, place.libre, place.indexLibre, true);
+  enlever(parOccupants, place.occupants, place.indexOccupants, false);
+
+  Resident *deplace = residences.back();
+  residences[place.indexToutes] = deplace;
+  residences.pop_back();
+  if (place.indexToutes < residences.size())
+    places.at(deplace).indexToutes = place.indexToutes;
+  places.erase(r);
+}
+
+void IndexResidences::actualiser(Resident *r) {
+  auto it = places.find(r);
+  if (it == places.end())
+    return;
+  int occupants = r->gethabitantsActuels();
+  int libre = std::max(0, r->getcapaciteHabitants() - occupants);
+  Place place = it->second;
+  if (libre != place.libre) {
+    enlever(parLibre, place.libre, place.indexLibre, true);
+    place.libre = libre;
+    inserer(parLibre, libre, r, place.indexLibre);
+  }
+  if (occupants != place.occupants) {
+    enlever(parOccupants, place.occupants, place.indexOccupants, false);
+    place.occupants = occupants;
+    inserer(parOccupants, occupants, r, place.indexOccupants);
+  }
+  places.at(r) = place;
+}
+
+Resident *IndexResidences::prochaineLibre(PolitiqueRemplissage politique) const {
+  int nbSeaux = static_cast<int>(parLibre.size());
+  if (politique == PolitiqueRemplissage::Compacte) {
+    for (int libre = 1; libre < nbSeaux; ++libre)
+      if (!parLibre[libre].empty())
+        return parLibre[libre].back();
+  } else {
+    for (int libre = nbSeaux - 1; libre >= 1; --libre)
+      if (!parLibre[libre].empty())
+        return parLibre[libre].back();
+  }
+  return nullptr;
+}
+
+Resident *
+IndexResidences::prochaineOccupee(PolitiqueRemplissage politique) const {
+  int nbSeaux = static_cast<int>(parOccupants.size());
+  if (politique == PolitiqueRemplissage::Compacte) {
+    for (int occupants = 1; occupants < nbSeaux; ++occupants)
+      if (!parOccupants[occupants].empty())
+        return parOccupants[occupants].back();
+  } else {
+    for (int occupants = nbSeaux - 1; occupants >= 1; --occupants)
+      if (!parOccupants[occupants].empty())
+        return parOccupants[occupants].back();
+  }
+  return nullptr;
+}
+
+const std::vector<Resident *> &IndexResidences::toutes() const {
+  return residences;
+}
+
+size_t IndexResidences::taille() const { return residences.size(); }
@@ -0,0 +1,464 @@
+#include "../include/ville/routes.hpp"
+#include "../include/cycle/parallele.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+#include <tuple>
+
+namespace {
+
+// Per-thread scratch for the searches, sized on first use
+struct Tampon {
+  std::vector<int> depuisDepart;
+  std::vector<int> depuisArrivee;
+  std::vector<int> parentLocal;
+  std::vector<int> file;
+  std::vector<int> cout;
+  std::vector<int> parent;
+  std::vector<unsigned int> marque;
+  unsigned int generation = 0;
+};
+
+thread_local Tampon tampon;
+
+constexpr int AUCUN = -1;
+
+} // namespace
+
+ReseauRoutier::ReseauRoutier(int largeur, int hauteur)
+    : largeur(std::max(0, largeur)), hauteur(std::max(0, hauteur)) {
+  chunksX = (this->largeur + TAILLE_CHUNK - 1) / TAILLE_CHUNK;
+  chunksY = (this->hauteur + TAILLE_CHUNK - 1) / TAILLE_CHUNK;
+  size_t tuiles = static_cast<size_t>(this->largeur) * this->hauteur;
+  size_t chunks = static_cast<size_t>(chunksX) * chunksY;
+  routes.assign(tuiles, 0);
+  references.assign(tuiles, 0);
+  aretes.resize(tuiles);
+  bordsH.resize(chunks);
+  bordsV.resize(chunks);
+  noeuds.resize(chunks);
+  chunksModifies.assign(chunks, 0);
+}
+
+bool ReseauRoutier::dansCarte(int x, int y) const {
+  return x >= 0 && y >= 0 && x < largeur && y < hauteur;
+}
+
+int ReseauRoutier::tuile(int x, int y) const { return y * largeur + x; }
+
+int ReseauRoutier::chunkDe(int t) const {
+  return (t / largeur / TAILLE_CHUNK) * chunksX + (t % largeur) / TAILLE_CHUNK;
+}
+
+bool ReseauRoutier::estRoute(int x, int y) const {
+  return dansCarte(x, y) && routes[tuile(x, y)];
+}
+
+size_t ReseauRoutier::getNombreRoutes() const { return nombreRoutes; }
+
+unsigned long ReseauRoutier::getRevision() const { return revision; }
+
+bool ReseauRoutier::ajouterRoute(Position position) {
+  if (!dansCarte(position.x, position.y) ||
+      routes[tuile(position.x, position.y)])
+    return false;
+  routes[tuile(position.x, position.y)] = 1;
+  ++nombreRoutes;
+  marquerModifie(position);
+  return true;
+}
+
+bool ReseauRoutier::retirerRoute(Position position) {
+  if (!estRoute(position.x, position.y))
+    return false;
+  routes[tuile(position.x, position.y)] = 0;
+  --nombreRoutes;
+  marquerModifie(position);
+  return true;
+}
+
+void ReseauRoutier::marquerModifie(Position position) {
+  chunksModifies[chunkDe(tuile(position.x, position.y))] = 1;
+  modifie = true;
+  ++revision;
+}
+
+// Entrances between chunk and its right (horizontal) or lower neighbour.
+// Short runs of road get one entrance in their middle, long ones one at
+// each end so paths hugging either side are not forced through the centre.
+void ReseauRoutier::calculerBord(std::vector<std::pair<int, int>> &bord,
+                                 int chunk, bool horizontal) {
+  for (const auto &[a, b] : bord) {
+    --references[a];
+    --references[b];
+  }
+  bord.clear();
+
+  int x0 = (chunk % chunksX) * TAILLE_CHUNK;
+  int y0 = (chunk / chunksX) * TAILLE_CHUNK;
+  int longueur = horizontal ? std::min(TAILLE_CHUNK, hauteur - y0)
+                            : std::min(TAILLE_CHUNK, largeur - x0);
+  auto paire = [&](int i) {
+    return horizontal
+               ? std::make_pair(tuile(x0 + TAILLE_CHUNK - 1, y0 + i),
+                                tuile(x0 + TAILLE_CHUNK, y0 + i))
+               : std::make_pair(tuile(x0 + i, y0 + TAILLE_CHUNK - 1),
+                                tuile(x0 + i, y0 + TAILLE_CHUNK));
+  };
+
+  int debut = AUCUN;
+  for (int i = 0; i <= longueur; ++i) {
+    bool ouvert = false;
+    if (i < longueur) {
+      auto [a, b] = paire(i);
+      ouvert = routes[a] && routes[b];
+    }
+    if (ouvert && debut == AUCUN)
+      debut = i;
+    if (ouvert || debut == AUCUN)
+      continue;
+    int fin = i - 1;
+    if (fin - debut + 1 > 5) {
+      bord.push_back(paire(debut));
+      bord.push_back(paire(fin));
+    } else {
+      bord.push_back(paire((debut + fin) / 2));
+    }
+    debut = AUCUN;
+  }
+
+  for (const auto &[a, b] : bord) {
+    ++references[a];
+    ++references[b];
+  }
+}
+
+void ReseauRoutier::preparer() {
+  if (!modifie)
+    return;
+  viderCache();
+
+  std::vector<unsigned char> aRelier(chunksModifies.size(), 0);
+  for (int c = 0; c < static_cast<int>(chunksModifies.size()); ++c) {
+    if (!chunksModifies[c])
+      continue;
+    chunksModifies[c] = 0;
+    int cx = c % chunksX;
+    int cy = c / chunksX;
+    aRelier[c] = 1;
+    if (cx > 0) {
+      calculerBord(bordsH[c - 1], c - 1, true);
+      aRelier[c - 1] = 1;
+    }
+    if (cx + 1 < chunksX) {
+      calculerBord(bordsH[c], c, true);
+      aRelier[c + 1] = 1;
+    }
+    if (cy > 0) {
+      calculerBord(bordsV[c - chunksX], c - chunksX, false);
+      aRelier[c - chunksX] = 1;
+    }
+    if (cy + 1 < chunksY) {
+      calculerBord(bordsV[c], c, false);
+      aRelier[c + chunksX] = 1;
+    }
+  }
+
+  std::vector<int> aTraiter;
+  for (int c = 0; c < static_cast<int>(aRelier.size()); ++c)
+    if (aRelier[c])
+      aTraiter.push_back(c);
+  // Chunks only read the shared borders, each writes its own tiles' edges
+  executerEnParallele(aTraiter.size(),
+                      [&](size_t i) { relierChunk(aTraiter[i]); });
+  modifie = false;
+}
+
+// Collect the chunk's entrances and link them to each other and across
+// the borders
+void ReseauRoutier::relierChunk(int chunk) {
+  for (int t : noeuds[chunk])
+    aretes[t].clear();
+  noeuds[chunk].clear();
+
+  int cx = chunk % chunksX;
+  int cy = chunk / chunksX;
+  auto passages = [&](const std::vector<std::pair<int, int>> &bord,
+                      bool ici) {
+    for (const auto &[a, b] : bord) {
+      int local = ici ? a : b;
+      aretes[local].push_back({ici ? b : a, 1});
+      noeuds[chunk].push_back(local);
+    }
+  };
+  if (cx > 0)
+    passages(bordsH[chunk - 1], false);
+  if (cx + 1 < chunksX)
+    passages(bordsH[chunk], true);
+  if (cy > 0)
+    passages(bordsV[chunk - chunksX], false);
+  if (cy + 1 < chunksY)
+    passages(bordsV[chunk], true);
+
+  auto &liste = noeuds[chunk];
+  std::sort(liste.begin(), liste.end());
+  liste.erase(std::unique(liste.begin(), liste.end()), liste.end());
+
+  std::vector<int> distances;
+  int x0 = cx * TAILLE_CHUNK;
+  int y0 = cy * TAILLE_CHUNK;
+  for (int t : liste) {
+    explorerChunk(t, distances);
+    for (int autre : liste) {
+      int d = distances[(autre / largeur - y0) * TAILLE_CHUNK +
+                        (autre % largeur - x0)];
+      if (autre != t && d != AUCUN)
+        aretes[t].push_back({autre, d});
+    }
+  }
+}
+
+// Breadth-first distances from a tile to every road tile of its chunk,
+// indexed by position inside the chunk
+void ReseauRoutier::explorerChunk(int depart,
+                                  std::vector<int> &distances) const {
+  distances.assign(TAILLE_CHUNK * TAILLE_CHUNK, AUCUN);
+  int chunk = chunkDe(depart);
+  int x0 = (chunk % chunksX) * TAILLE_CHUNK;
+  int y0 = (chunk / chunksX) * TAILLE_CHUNK;
+  int x1 = std::min(x0 + TAILLE_CHUNK, largeur);
+  int y1 = std::min(y0 + TAILLE_CHUNK, hauteur);
+
+  std::vector<int> &file = tampon.file;
+  file.clear();
+  file.push_back(depart);
+  distances[(depart / largeur - y0) * TAILLE_CHUNK + (depart % largeur - x0)] =
+      0;
+  for (size_t i = 0; i < file.size(); ++i) {
+    int x = file[i] % largeur;
+    int y = file[i] / largeur;
+    int d = distances[(y - y0) * TAILLE_CHUNK + (x - x0)];
+    const int voisins[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+    for (const auto &[vx, vy] : voisins) {
+      if (vx < x0 || vy < y0 || vx >= x1 || vy >= y1 || !routes[tuile(vx, vy)])
+        continue;
+      int &dv = distances[(vy - y0) * TAILLE_CHUNK + (vx - x0)];
+      if (dv != AUCUN)
+        continue;
+      dv = d + 1;
+      file.push_back(tuile(vx, vy));
+    }
+  }
+}
+
+// A* over the entrances, the endpoints being attached to the entrances of
+// their own chunk. Fills parcours with depart, the entrances crossed and
+// arrivee when asked.
+int ReseauRoutier::rechercher(int depart, int arrivee,
+                              std::vector<int> *parcours) const {
+  if (!routes[depart] || !routes[arrivee])
+    return AUCUN;
+  if (depart == arrivee) {
+    if (parcours)
+      *parcours = {depart};
+    return 0;
+  }
+
+  int chunkDepart = chunkDe(depart);
+  int chunkArrivee = chunkDe(arrivee);
+  auto local = [&](int t, int chunk) {
+    return (t / largeur - (chunk / chunksX) * TAILLE_CHUNK) * TAILLE_CHUNK +
+           (t % largeur - (chunk % chunksX) * TAILLE_CHUNK);
+  };
+  explorerChunk(depart, tampon.depuisDepart);
+  explorerChunk(arrivee, tampon.depuisArrivee);
+
+  int meilleur = AUCUN;
+  int fin = AUCUN; // entrance the best path leaves from, none when direct
+  if (chunkDepart == chunkArrivee)
+    meilleur = tampon.depuisDepart[local(arrivee, chunkDepart)];
+
+  size_t tuiles = routes.size();
+  if (tampon.marque.size() < tuiles) {
+    tampon.marque.assign(tuiles, 0);
+    tampon.cout.resize(tuiles);
+    tampon.parent.resize(tuiles);
+    tampon.generation = 0;
+  }
+  if (++tampon.generation == 0) {
+    std::fill(tampon.marque.begin(), tampon.marque.end(), 0);
+    tampon.generation = 1;
+  }
+  const unsigned int generation = tampon.generation;
+
+  int ax = arrivee % largeur;
+  int ay = arrivee / largeur;
+  auto heuristique = [&](int t) {
+    return std::abs(t % largeur - ax) + std::abs(t / largeur - ay);
+  };
+
+  using Entree = std::tuple<int, int, int>; // f, g, tile
+  std::priority_queue<Entree, std::vector<Entree>, std::greater<Entree>> file;
+  for (int t : noeuds[chunkDepart]) {
+    int d = tampon.depuisDepart[local(t, chunkDepart)];
+    if (d == AUCUN)
+      continue;
+    tampon.marque[t] = generation;
+    tampon.cout[t] = d;
+    tampon.parent[t] = AUCUN;
+    file.emplace(d + heuristique(t), d, t);
+  }
+
+  while (!file.empty()) {
+    auto [f, g, t] = file.top();
+    file.pop();
+    if (meilleur != AUCUN && f >= meilleur)
+      break;
+    if (g > tampon.cout[t])
+      continue;
+    if (chunkDe(t) == chunkArrivee) {
+      int reste = tampon.depuisArrivee[local(t, chunkArrivee)];
+      if (reste != AUCUN && (meilleur == AUCUN || g + reste < meilleur)) {
+        meilleur = g + reste;
+        fin = t;
+      }
+    }
+    for (const Arete &arete : aretes[t]) {
+      int ng = g + arete.cout;
+      int v = arete.tuile;
+      if (tampon.marque[v] == generation && ng >= tampon.cout[v])
+        continue;
+      tampon.marque[v] = generation;
+      tampon.cout[v] = ng;
+      tampon.parent[v] = t;
+      file.emplace(ng + heuristique(v), ng, v);
+    }
+  }
+
+  if (parcours && meilleur != AUCUN) {
+    parcours->clear();
+    for (int t = fin; t != AUCUN; t = tampon.parent[t])
+      parcours->push_back(t);
+    parcours->push_back(depart);
+    std::reverse(parcours->begin(), parcours->end());
+    parcours->push_back(arrivee);
+  }
+  return meilleur;
+}
+
+int ReseauRoutier::distance(Position depart, Position arrivee) const {
+  if (!dansCarte(depart.x, depart.y) || !dansCarte(arrivee.x, arrivee.y))
+    return AUCUN;
+  int a = tuile(depart.x, depart.y);
+  int b = tuile(arrivee.x, arrivee.y);
+  if (a > b)
+    std::swap(a, b); // distances are symmetric, share one entry
+  unsigned long long cle =
+      (static_cast<unsigned long long>(a) << 32) | static_cast<unsigned>(b);
+  Tranche &tranche =
+      cache[(cle * 0x9E3779B97F4A7C15ull) >> 60 & (NOMBRE_TRANCHES - 1)];
+  {
+    std::lock_guard<std::mutex> verrou(tranche.verrou);
+    auto it = tranche.distances.find(cle);
+    if (it != tranche.distances.end())
+      return it->second;
+  }
+
+  int resultat = rechercher(a, b, nullptr);
+
+  std::lock_guard<std::mutex> verrou(tranche.verrou);
+  if (tranche.distances.size() >= TAILLE_MAX_TRANCHE)
+    tranche.distances.clear();
+  tranche.distances.emplace(cle, resultat);
+  return resultat;
+}
+
+void ReseauRoutier::distances(
+    std::span<const std::pair<Position, Position>> requetes,
+    std::vector<int> &resultats) {
+  preparer();
+  resultats.assign(requetes.size(), AUCUN);
+  constexpr size_t PAQUET = 256;
+  executerEnParallele((requetes.size() + PAQUET - 1) / PAQUET, [&](size_t p) {
+    size_t fin = std::min(requetes.size(), (p + 1) * PAQUET);
+    for (size_t i = p * PAQUET; i < fin; ++i)
+      resultats[i] = distance(requetes[i].first, requetes[i].second);
+  });
+}
+
+// Tile by tile path between two road tiles of the same chunk
+bool ReseauRoutier::cheminLocal(int depart, int arrivee,
+                                std::vector<Position> &resultat) const {
+  int chunk = chunkDe(depart);
+  int x0 = (chunk % chunksX) * TAILLE_CHUNK;
+  int y0 = (chunk / chunksX) * TAILLE_CHUNK;
+  int x1 = std::min(x0 + TAILLE_CHUNK, largeur);
+  int y1 = std::min(y0 + TAILLE_CHUNK, hauteur);
+  auto local = [&](int t) {
+    return (t / largeur - y0) * TAILLE_CHUNK + (t % largeur - x0);
+  };
+
+  std::vector<int> &parents = tampon.parentLocal;
+  parents.assign(TAILLE_CHUNK * TAILLE_CHUNK, AUCUN);
+  std::vector<int> &file = tampon.file;
+  file.clear();
+  file.push_back(depart);
+  parents[local(depart)] = depart;
+  for (size_t i = 0; i < file.size() && parents[local(arrivee)] == AUCUN;
+       ++i) {
+    int x = file[i] % largeur;
+    int y = file[i] / largeur;
+    const int voisins[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+    for (const auto &[vx, vy] : voisins) {
+      if (vx < x0 || vy < y0 || vx >= x1 || vy >= y1 || !routes[tuile(vx, vy)])
+        continue;
+      int v = tuile(vx, vy);
+      if (parents[local(v)] != AUCUN)
+        continue;
+      parents[local(v)] = file[i];
+      file.push_back(v);
+    }
+  }
+  if (parents[local(arrivee)] == AUCUN)
+    return false;
+
+  size_t debut = resultat.size();
+  for (int t = arrivee; t != depart; t = parents[local(t)])
+    resultat.push_back(Position(t % largeur, t / largeur));
+  std::reverse(resultat.begin() + debut, resultat.end());
+  return true;
+}
+
+bool ReseauRoutier::chemin(Position depart, Position arrivee,
+                           std::vector<Position> &resultat) const {
+  resultat.clear();
+  if (!estRoute(depart.x, depart.y) || !estRoute(arrivee.x, arrivee.y))
+    return false;
+
+  std::vector<int> parcours;
+  if (rechercher(tuile(depart.x, depart.y), tuile(arrivee.x, arrivee.y),
+                 &parcours) == AUCUN)
+    return false;
+
+  // Refine: consecutive waypoints share a chunk or face each other across
+  // a border
+  resultat.push_back(depart);
+  for (size_t i = 1; i < parcours.size(); ++i) {
+    int a = parcours[i - 1];
+    int b = parcours[i];
+    if (a == b)
+      continue;
+    if (chunkDe(a) != chunkDe(b))
+      resultat.push_back(Position(b % largeur, b / largeur));
+    else if (!cheminLocal(a, b, resultat))
+      return false;
+  }
+  return true;
+}
+
+void ReseauRoutier::viderCache() {
+  for (Tranche &tranche : cache) {
+    std::lock_guard<std::mutex> verrou(tranche.verrou);
+    tranche.distances.clear();
+  }
+}
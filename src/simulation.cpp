@@ -1,8 +1,20 @@
 #include "../include/cycle/simulation.hpp"
 #include "../include/buildings/batiment.hpp"
+#include "../include/buildings/traits.hpp"
+#include "../include/cycle/ordonnanceur.hpp"
 #include "../include/evenement.hpp"
+#include <cstdlib>
 #include <iostream>
 
+namespace {
+
+// Label values of the metrics, in enum order
+const char *const NOMS_CATEGORIES[] = {
+    "Natural",  "Social", "Economic",  "Technical", "Entertainment",
+    "Seasonal", "Health", "Transport", "Wildlife"};
+
+} // namespace
+
 Simulation::Simulation(const string &nomVille, Difficulty difficulty)
     : ville(nomVille,
             (difficulty == Difficulty::Easy     ? 2000.0
@@ -16,27 +28,77 @@ Simulation::Simulation(const string &nomVille, Difficulty difficulty)
   this->difficulty = difficulty;
   cycleActuel = 0;
   
+  // Building names are read once here, never while building
+  NameGenerator::initializeNames();
+
   // Initialize event system
   eventManager.initialiserEvenements();
   evenementActuel = nullptr;
-  
+
+  enregistrerMetriques();
+  // Hosts without a command line (headless runs) serve the metrics too
+  if (const char *port = std::getenv("VC_METRICS_PORT"))
+    if (!exposerMetriques(static_cast<unsigned short>(std::atoi(port))))
+      std::cerr << "Metrics endpoint unavailable on port " << port << "\n";
   demarerCycle();
 }
 
 bool Simulation::canInteract() const { return state == SimState::Running; }
 
+void Simulation::setCycleParallele(bool actif) { cycleParallele = actif; }
+
+bool Simulation::getCycleParallele() const { return cycleParallele; }
+
 void Simulation::terminerCycle() {
   std::cout << "Terminer working\n";
   state = SimState::Evaluating;
 
-  // Computing stats
-  ville.collectProfit();
-  ville.calculerPolutionTotale();
-  ville.assignerEmplois();        // Distribute population to jobs
-  ville.calculerSatisfactionTotale();
-  ville.updatePopulation();
+  // Computing stats. Each phase waits for the phases whose results it
+  // reads and for those still reading what it overwrites; the insertion
+  // order is the serial order.
+  GrapheTaches phases;
+  int profit = phases.ajouter("profit", [&]() { ville.collectProfit(); });
+  int diffusion =
+      phases.ajouter("diffusion", [&]() { ville.diffuserPollution(); });
+  int pollution = phases.ajouter( // City gauge from the field
+      "pollution", [&]() { ville.calculerPolutionTotale(); },
+      {profit, diffusion});
+  int emplois = phases.ajouter( // Distribute population to jobs
+      "jobs", [&]() { ville.assignerEmplois(); }, {profit});
+  int ressources = phases.ajouter( // Plants serve the connected buildings
+      "resources", [&]() { ville.distribuerRessources(); }, {emplois});
+  int trafic = phases.ajouter( // Commuters drive to work
+      "traffic", [&]() { ville.simulerTrafic(); }, {emplois});
+  int satisfaction = phases.ajouter(
+      "satisfaction", [&]() { ville.calculerSatisfactionTotale(); },
+      {pollution, emplois, trafic});
+  phases.ajouter(
+      "population", [&]() { ville.updatePopulation(); },
+      {satisfaction, diffusion, ressources});
+  phases.executer(cycleParallele);
+  dureesPhases.clear();
+  for (int i = 0; i < static_cast<int>(phases.taille()); ++i)
+    dureesPhases.emplace_back(phases.getNom(i), phases.getDuree(i));
   cycleActuel++;
 
+  if (metriquesPhases.empty())
+    for (const auto &[nom, duree] : dureesPhases)
+      metriquesPhases.push_back(metriques.enregistrer(
+          RegistreMetriques::Genre::Jauge, "ville_phase_duree_ms",
+          "Duration of each end of cycle phase, last cycle",
+          "phase=\"" + nom + "\""));
+  for (size_t i = 0; i < dureesPhases.size() && i < metriquesPhases.size();
+       ++i)
+    metriques.fixer(metriquesPhases[i], dureesPhases[i].second);
+  auto maintenant = chrono::steady_clock::now();
+  double ecoule =
+      chrono::duration<double>(maintenant - finCyclePrecedent).count();
+  finCyclePrecedent = maintenant;
+  metriques.ajouter(metriqueCycles, 1.0);
+  metriques.fixer(metriqueCyclesParSeconde, ecoule > 0.0 ? 1.0 / ecoule : 0.0);
+  publierStats();
+  enregistrerHistorique();
+
   // GAME OVER check
   if (ville.getPopulation() <= 0 && ville.getBudget() <= 0 &&
       ville.getSatisfaction() <= 0) {
@@ -69,6 +131,90 @@ void Simulation::demarerCycle() {
   
   // Try to trigger a random event
   declencherEvenement();
+  publierStats();
+}
+
+void Simulation::publierStats() {
+  auto nouvelles = std::make_shared<CityStats>();
+  nouvelles->nom = ville.getNom();
+  nouvelles->population = ville.getPopulation();
+  nouvelles->emploiActuel = ville.calculerEmploiActuel();
+  nouvelles->capaciteEmploi = ville.calculerCapaciteEmploi();
+  nouvelles->tauxChomage = ville.calculerTauxChomage();
+  nouvelles->satisfaction = ville.getSatisfaction();
+  nouvelles->budget = ville.getBudget();
+  nouvelles->cycle = cycleActuel;
+  stats = std::move(nouvelles);
+  actualiserMetriques();
+}
+
+void Simulation::enregistrerMetriques() {
+  using Genre = RegistreMetriques::Genre;
+  metriqueCycles = metriques.enregistrer(Genre::Compteur, "ville_cycles_total",
+                                         "Cycles completed");
+  metriqueCyclesParSeconde =
+      metriques.enregistrer(Genre::Jauge, "ville_cycles_par_seconde",
+                            "Cycle rate, from the last two cycle ends");
+  metriquePopulation = metriques.enregistrer(Genre::Jauge, "ville_population",
+                                             "Inhabitants");
+  metriqueBudget =
+      metriques.enregistrer(Genre::Jauge, "ville_budget", "City budget");
+  metriqueBatiments = metriques.taille();
+  for (const TraitsBatiment &traits : TRAITS_BATIMENTS)
+    metriques.enregistrer(Genre::Jauge, "ville_batiments",
+                          "Buildings by type",
+                          "type=\"" + string(traits.nom) + "\"");
+  metriqueAjoutes =
+      metriques.enregistrer(Genre::Compteur, "ville_batiments_ajoutes_total",
+                            "Building objects created");
+  metriqueRetires =
+      metriques.enregistrer(Genre::Compteur, "ville_batiments_retires_total",
+                            "Building objects destroyed");
+  metriqueEvenements = metriques.taille();
+  for (const char *categorie : NOMS_CATEGORIES)
+    metriques.enregistrer(Genre::Compteur, "ville_evenements_total",
+                          "Events triggered by category",
+                          "categorie=\"" + string(categorie) + "\"");
+  finCyclePrecedent = chrono::steady_clock::now();
+}
+
+// Figures that change with edits as well as with cycles
+void Simulation::actualiserMetriques() {
+  metriques.fixer(metriquePopulation, ville.getPopulation());
+  metriques.fixer(metriqueBudget, ville.getBudget());
+  for (size_t i = 0; i < NOMBRE_TYPES_BATIMENT; ++i)
+    metriques.fixer(metriqueBatiments + i,
+                    ville.getNombreBatiments(static_cast<TypeBatiment>(i)));
+  metriques.fixer(metriqueAjoutes, ville.getBatimentsAjoutes());
+  metriques.fixer(metriqueRetires, ville.getBatimentsRetires());
+}
+
+bool Simulation::exposerMetriques(unsigned short port) {
+  serveurMetriques = std::make_unique<ServeurMetriques>(metriques);
+  return serveurMetriques->demarrer(port);
+}
+
+const RegistreMetriques &Simulation::getMetriques() const { return metriques; }
+
+void Simulation::enregistrerHistorique() {
+  Releve releve;
+  releve.cycle = cycleActuel;
+  releve.budget = static_cast<float>(ville.getBudget());
+  releve.population = static_cast<float>(ville.getPopulation());
+  releve.satisfaction = static_cast<float>(ville.getSatisfaction());
+  releve.pollution = ville.getPolution();
+  releve.chomage = ville.calculerTauxChomage();
+  releve.evenement = evenementActuel ? evenementActuel->getId() : -1;
+  historique.enregistrer(releve);
+  historiquePartage.reset();
+}
+
+const Historique &Simulation::getHistorique() const { return historique; }
+
+shared_ptr<const Historique> Simulation::partagerHistorique() {
+  if (!historiquePartage)
+    historiquePartage = std::make_shared<Historique>(historique);
+  return historiquePartage;
 }
 
 void Simulation::declencherEvenement() {
@@ -78,6 +224,9 @@ void Simulation::declencherEvenement() {
   if (evenementActuel) {
     // Apply the event
     evenementActuel->appliquer(&ville);
+    metriques.ajouter(metriqueEvenements +
+                          static_cast<size_t>(evenementActuel->getCategory()),
+                      1.0);
   } else {
     std::cout << "Aucun événement ce cycle. Tout est calme." << std::endl;
   }
@@ -98,6 +247,10 @@ int Simulation::getCycle() const { return cycleActuel; }
 float Simulation::getTimePerCycle() const { return TimePerCycle; }
 float Simulation::getCurrentTime() const { return currentTime; }
 SimState Simulation::getState() const { return state; }
+const vector<pair<string, double>> &Simulation::getDureesPhases() const {
+  return dureesPhases;
+}
+shared_ptr<const CityStats> Simulation::getStats() const { return stats; }
 const Ville &Simulation::getVille() const { return ville; }
 Ville &Simulation::getVille() { return ville; }
 const Evenement* Simulation::getEvenementActuel() const { 
@@ -0,0 +1,192 @@
+#include "../include/ville/trafic.hpp"
+#include "../include/cycle/parallele.hpp"
+#include <algorithm>
+
+namespace {
+
+constexpr size_t TAILLE_BLOC = 1 << 16;
+constexpr uint16_t EN_ROUTE = 0xFFFF;
+
+// Deterministic per agent and step, so admissions do not depend on the
+// order the threads run in
+uint32_t melanger(uint32_t agent, uint32_t pas) {
+  uint64_t h = (static_cast<uint64_t>(agent) << 32 | pas) *
+               0x9E3779B97F4A7C15ull;
+  h ^= h >> 29;
+  h *= 0xBF58476D1CE4E5B9ull;
+  return static_cast<uint32_t>(h >> 32);
+}
+
+} // namespace
+
+TraficAgents::TraficAgents(int largeur, int hauteur)
+    : largeur(std::max(0, largeur)), hauteur(std::max(0, hauteur)) {
+  size_t tuiles = static_cast<size_t>(this->largeur) * this->hauteur;
+  charge.assign(tuiles, 0);
+  demande.assign(tuiles, 0);
+}
+
+void TraficAgents::vider() {
+  tuilesChemins.clear();
+  debutsChemins.assign(1, 0);
+  cheminAgent.clear();
+  groupeAgent.clear();
+  departAgent.clear();
+  etapeAgent.clear();
+  arriveeAgent.clear();
+  std::fill(charge.begin(), charge.end(), 0);
+  retardGroupes.clear();
+  agentsGroupes.clear();
+  retardTotal = 0.0;
+  tempsLibreTotal = 0.0;
+}
+
+void TraficAgents::ajouterTrajet(const std::vector<Position> &chemin,
+                                 uint32_t nombre, uint32_t groupe) {
+  if (chemin.empty() || nombre == 0 || chemin.size() > EN_ROUTE)
+    return;
+  for (const Position &p : chemin)
+    if (p.x < 0 || p.y < 0 || p.x >= largeur || p.y >= hauteur)
+      return;
+
+  uint32_t id = static_cast<uint32_t>(debutsChemins.size() - 1);
+  for (const Position &p : chemin)
+    tuilesChemins.push_back(p.y * largeur + p.x);
+  debutsChemins.push_back(static_cast<uint32_t>(tuilesChemins.size()));
+
+  size_t total = cheminAgent.size() + nombre;
+  for (size_t agent = cheminAgent.size(); agent < total; ++agent) {
+    cheminAgent.push_back(id);
+    groupeAgent.push_back(groupe);
+    departAgent.push_back(melanger(static_cast<uint32_t>(agent), 0) %
+                          FENETRE_DEPART);
+  }
+  etapeAgent.resize(total);
+  arriveeAgent.resize(total);
+  if (groupe >= agentsGroupes.size()) {
+    agentsGroupes.resize(groupe + 1, 0);
+    retardGroupes.resize(groupe + 1, 0.0);
+  }
+}
+
+void TraficAgents::simuler() {
+  size_t agents = cheminAgent.size();
+  size_t tuiles = charge.size();
+  std::fill(charge.begin(), charge.end(), 0);
+  std::fill(etapeAgent.begin(), etapeAgent.end(), 0);
+  std::fill(arriveeAgent.begin(), arriveeAgent.end(), EN_ROUTE);
+
+  size_t blocs = (agents + TAILLE_BLOC - 1) / TAILLE_BLOC;
+  // Counters are accumulated per block then summed, no atomics needed
+  std::vector<std::vector<uint32_t>> demandesLocales(
+      blocs, std::vector<uint32_t>(tuiles));
+  std::vector<std::vector<uint32_t>> chargesLocales(
+      blocs, std::vector<uint32_t>(tuiles));
+  std::vector<size_t> arrivees(blocs);
+  std::fill(demande.begin(), demande.end(), 0);
+  size_t restants = agents;
+
+  auto dernier = [&](size_t agent) {
+    uint32_t c = cheminAgent[agent];
+    return debutsChemins[c + 1] - debutsChemins[c] - 1;
+  };
+  auto additionner = [&](std::vector<uint32_t> &total,
+                         const std::vector<std::vector<uint32_t>> &locaux,
+                         bool cumuler) {
+    size_t tranches = (tuiles + 4095) / 4096;
+    executerEnParallele(tranches, [&](size_t t) {
+      size_t fin = std::min(tuiles, (t + 1) * 4096);
+      for (size_t i = t * 4096; i < fin; ++i) {
+        uint32_t somme = cumuler ? total[i] : 0;
+        for (const auto &local : locaux)
+          somme += local[i];
+        total[i] = somme;
+      }
+    });
+  };
+
+  // A tile that was asked for by more agents than its capacity during the
+  // previous step admits each candidate with probability capacity/demand
+  for (uint32_t pas = 0; pas < PAS_MAX && restants > 0; ++pas) {
+    executerEnParallele(blocs, [&](size_t b) {
+      auto &demandeLocale = demandesLocales[b];
+      auto &chargeLocale = chargesLocales[b];
+      std::fill(demandeLocale.begin(), demandeLocale.end(), 0);
+      std::fill(chargeLocale.begin(), chargeLocale.end(), 0);
+      arrivees[b] = 0;
+      size_t fin = std::min(agents, (b + 1) * TAILLE_BLOC);
+      for (size_t a = b * TAILLE_BLOC; a < fin; ++a) {
+        if (arriveeAgent[a] != EN_ROUTE || pas < departAgent[a])
+          continue;
+        const int *chemin = &tuilesChemins[debutsChemins[cheminAgent[a]]];
+        uint32_t derniere = dernier(a);
+        if (etapeAgent[a] < derniere) {
+          int suivante = chemin[etapeAgent[a] + 1];
+          uint32_t d = demande[suivante];
+          if (d <= CAPACITE_ROUTE ||
+              melanger(static_cast<uint32_t>(a), pas + 1) % d <
+                  CAPACITE_ROUTE) {
+            ++etapeAgent[a];
+            ++chargeLocale[suivante];
+          }
+        }
+        if (etapeAgent[a] >= derniere) {
+          arriveeAgent[a] = static_cast<uint16_t>(
+              etapeAgent[a] == 0 ? departAgent[a] : pas + 1);
+          ++arrivees[b];
+          continue;
+        }
+        ++demandeLocale[chemin[etapeAgent[a] + 1]];
+      }
+    });
+    additionner(demande, demandesLocales, false);
+    additionner(charge, chargesLocales, true);
+    for (size_t n : arrivees)
+      restants -= n;
+  }
+
+  // Statistics, summed in agent order so they do not depend on threading
+  std::fill(retardGroupes.begin(), retardGroupes.end(), 0.0);
+  std::fill(agentsGroupes.begin(), agentsGroupes.end(), 0);
+  retardTotal = 0.0;
+  tempsLibreTotal = 0.0;
+  for (size_t a = 0; a < agents; ++a) {
+    double libre = dernier(a);
+    // An agent still out has at least waited for every step it did not
+    // move; the tiles it has left take no less than their free-flow time
+    double retard =
+        arriveeAgent[a] == EN_ROUTE
+            ? double(PAS_MAX - departAgent[a] - etapeAgent[a])
+            : std::max(0.0, arriveeAgent[a] - departAgent[a] - libre);
+    retardTotal += retard;
+    tempsLibreTotal += libre;
+    retardGroupes[groupeAgent[a]] += retard;
+    ++agentsGroupes[groupeAgent[a]];
+  }
+}
+
+size_t TraficAgents::getNombreAgents() const { return cheminAgent.size(); }
+
+uint32_t TraficAgents::getCharge(int x, int y) const {
+  if (x < 0 || y < 0 || x >= largeur || y >= hauteur)
+    return 0;
+  return charge[static_cast<size_t>(y) * largeur + x];
+}
+
+float TraficAgents::getRetardMoyen() const {
+  return cheminAgent.empty() ? 0.0f
+                             : static_cast<float>(retardTotal /
+                                                  cheminAgent.size());
+}
+
+float TraficAgents::getRetardRelatif() const {
+  return tempsLibreTotal <= 0.0
+             ? 0.0f
+             : static_cast<float>(retardTotal / tempsLibreTotal);
+}
+
+float TraficAgents::getRetardGroupe(uint32_t groupe) const {
+  if (groupe >= agentsGroupes.size() || agentsGroupes[groupe] == 0)
+    return 0.0f;
+  return static_cast<float>(retardGroupes[groupe] / agentsGroupes[groupe]);
+}
@@ -2,96 +2,131 @@
 #include <stdexcept>
 #include <iostream>
 
-// Definition
-std::hash<std::string> BuildingIDGenerator::string_hasher;
-std::random_device BuildingIDGenerator::rd;
-std::mt19937 BuildingIDGenerator::gen(BuildingIDGenerator::rd());
-std::uniform_int_distribution<int> BuildingIDGenerator::dist(1000, 9999);
+std::shared_mutex TableNoms::verrou;
+std::array<std::unique_ptr<std::string[]>, TableNoms::NOMBRE_BLOCS>
+    TableNoms::blocs;
+std::atomic<NomId> TableNoms::publies{0};
+std::unordered_map<std::string_view, NomId> TableNoms::index;
+
+// Les recherches partagent le verrou, seul un nouveau nom le prend en
+// exclusif
+NomId TableNoms::interner(std::string_view nom) {
+    {
+        std::shared_lock<std::shared_mutex> lecture(verrou);
+        auto it = index.find(nom);
+        if (it != index.end())
+            return it->second;
+    }
+    std::unique_lock<std::shared_mutex> ecriture(verrou);
+    auto it = index.find(nom);
+    if (it != index.end())
+        return it->second;
+    NomId id = publies.load(std::memory_order_relaxed);
+    if (id >= TAILLE_BLOC * NOMBRE_BLOCS)
+        throw std::length_error("TableNoms : trop de noms distincts");
+    auto& bloc = blocs[id / TAILLE_BLOC];
+    if (!bloc)
+        bloc = std::make_unique<std::string[]>(TAILLE_BLOC);
+    std::string& place = bloc[id % TAILLE_BLOC];
+    place = nom;
+    index.emplace(place, id);
+    // Le nom et son bloc sont écrits avant que get() ne puisse les lire
+    publies.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+// Sans verrou : un nom publié n'est plus jamais modifié
+std::string_view TableNoms::get(NomId id) {
+    if (id >= publies.load(std::memory_order_acquire))
+        return std::string_view();
+    return blocs[id / TAILLE_BLOC][id % TAILLE_BLOC];
+}
 
-// Implémentation
-int BuildingIDGenerator::generateID(const std::string& name, TypeBatiment type, 
-                                   const Position& position, const Surface& surface) {
-    std::string unique_string = 
-        name + "_" +
-        std::to_string(static_cast<int>(type)) + "_" +
-        position.toString() + "_" +
-        std::to_string(static_cast<int>(surface.largeur)) + "x" +
-        std::to_string(static_cast<int>(surface.longeur)) + "_" +
-        std::to_string(dist(gen));
-    
-    size_t hash = string_hasher(unique_string);
-    return static_cast<int>(hash & 0x7FFFFFFF);
+size_t TableNoms::taille() {
+    return publies.load(std::memory_order_acquire);
 }
 
+namespace {
+
+// Clé dans building-names.json et noms de secours de chaque type
+struct SourceNoms {
+    TypeBatiment type;
+    const char* cle;
+    std::vector<std::string> secours;
+};
+
+const SourceNoms SOURCES_NOMS[] = {
+    {TypeBatiment::House, "House", {"Maison 1", "Maison 2", "Maison 3"}},
+    {TypeBatiment::Apartment, "Apartment", {"Appartement 1", "Appartement 2", "Appartement 3"}},
+    {TypeBatiment::Park, "Park", {"Parc Central", "Jardin Public", "Square"}},
+    {TypeBatiment::Cinema, "Cinema", {"Cinéma 1", "Cinéma 2", "Cinéma 3"}},
+    {TypeBatiment::Mall, "Mall", {"Centre Commercial", "Galerie Marchande", "Shopping Center"}},
+    {TypeBatiment::Bank, "Bank", {"Banque 1", "Banque 2", "Banque 3"}},
+    {TypeBatiment::PowerPlant, "PowerPlant", {"Centrale Électrique", "Usine d'Électricité"}},
+    {TypeBatiment::WaterTreatmentPlant, "WaterTreatmentPlant", {"Station d'Épuration", "Usine de Traitement d'Eau"}},
+    {TypeBatiment::UtilityPlant, "UtilityPlant", {"Usine des Services", "Complexe des Services"}},
+};
+
+} // namespace
+
 // Definition
-std::map<TypeBatiment, std::vector<std::string>> NameGenerator::buildingNames;
-std::random_device NameGenerator::rd;
-std::mt19937 NameGenerator::gen(NameGenerator::rd());
-bool NameGenerator::initialized = false;
+std::array<std::vector<std::string_view>, NOMBRE_TYPES_BATIMENT>
+    NameGenerator::buildingNames;
+std::once_flag NameGenerator::initialisation;
+std::atomic<bool> NameGenerator::pret{false};
 
-// Implémentation 
 void NameGenerator::initializeNames() {
-    if (initialized) return;
-    
-    try {
-        std::ifstream file("building-names.json");
-        if (!file.is_open()) {
-            std::cerr << "Fichier building-names.json non trouvé. Utilisation des noms par défaut." << std::endl;
-            buildingNames[TypeBatiment::House] = {"Maison 1", "Maison 2", "Maison 3"};
-            buildingNames[TypeBatiment::Apartment] = {"Appartement 1", "Appartement 2", "Appartement 3"};
-            buildingNames[TypeBatiment::Park] = {"Parc Central", "Jardin Public", "Square"};
-            buildingNames[TypeBatiment::Cinema] = {"Cinéma 1", "Cinéma 2", "Cinéma 3"};
-            buildingNames[TypeBatiment::Mall] = {"Centre Commercial", "Galerie Marchande", "Shopping Center"};
-            buildingNames[TypeBatiment::Bank] = {"Banque 1", "Banque 2", "Banque 3"};
-            buildingNames[TypeBatiment::PowerPlant] = {"Centrale Électrique", "Usine d'Électricité"};
-            buildingNames[TypeBatiment::WaterTreatmentPlant] = {"Station d'Épuration", "Usine de Traitement d'Eau"};
-            buildingNames[TypeBatiment::UtilityPlant] = {"Usine des Services", "Complexe des Services"};
-        } else {
-            json j;
-            try {
-                file >> j;
-                std::cout << "Fichier building-names.json chargé avec succès!" << std::endl;
+    std::call_once(initialisation, chargerNoms);
+}
 
-                buildingNames[TypeBatiment::House] = j["House"].get<std::vector<std::string>>();
-                buildingNames[TypeBatiment::Apartment] = j["Apartment"].get<std::vector<std::string>>();
-                buildingNames[TypeBatiment::Park] = j["Park"].get<std::vector<std::string>>();
-                buildingNames[TypeBatiment::Cinema] = j["Cinema"].get<std::vector<std::string>>();
-                buildingNames[TypeBatiment::Mall] = j["Mall"].get<std::vector<std::string>>();
-                buildingNames[TypeBatiment::Bank] = j["Bank"].get<std::vector<std::string>>();
-                buildingNames[TypeBatiment::PowerPlant] = j["PowerPlant"].get<std::vector<std::string>>();
-                buildingNames[TypeBatiment::WaterTreatmentPlant] = j["WaterTreatmentPlant"].get<std::vector<std::string>>();
-                buildingNames[TypeBatiment::UtilityPlant] = j["UtilityPlant"].get<std::vector<std::string>>();
-            } catch (const std::exception& json_error) {
-                std::cerr << "Erreur de parsing JSON: " << json_error.what() << std::endl;
-                throw;
+// Implémentation 
+void NameGenerator::chargerNoms() {
+    json j;
+    std::ifstream file("building-names.json");
+    if (!file.is_open()) {
+        std::cerr << "Fichier building-names.json non trouvé. Utilisation des noms par défaut." << std::endl;
+    } else {
+        try {
+            file >> j;
+            std::cout << "Fichier building-names.json chargé avec succès!" << std::endl;
+        } catch (const std::exception& json_error) {
+            std::cerr << "Erreur de parsing JSON: " << json_error.what() << std::endl;
+            j = json();
+        }
+    }
+
+    // Un type absent ou mal formé garde ses noms de secours
+    for (const SourceNoms& source : SOURCES_NOMS) {
+        std::vector<std::string> names = source.secours;
+        if (j.is_object() && j.contains(source.cle)) {
+            try {
+                names = j[source.cle].get<std::vector<std::string>>();
+            } catch (const std::exception& e) {
+                std::cerr << "Erreur lors du chargement des noms de bâtiments: " << e.what() << std::endl;
             }
         }
-        initialized = true;
-    } catch (const std::exception& e) {
-        std::cerr << "Erreur lors du chargement des noms de bâtiments: " << e.what() << std::endl;
-        // Fallback final
-        buildingNames[TypeBatiment::House] = {"Maison 1", "Maison 2", "Maison 3"};
-        buildingNames[TypeBatiment::Apartment] = {"Appartement 1", "Appartement 2", "Appartement 3"};
-        buildingNames[TypeBatiment::Park] = {"Parc Central", "Jardin Public", "Square"};
-        buildingNames[TypeBatiment::Cinema] = {"Cinéma 1", "Cinéma 2", "Cinéma 3"};
-        buildingNames[TypeBatiment::Mall] = {"Centre Commercial", "Galerie Marchande", "Shopping Center"};
-        buildingNames[TypeBatiment::Bank] = {"Banque 1", "Banque 2", "Banque 3"};
-        buildingNames[TypeBatiment::PowerPlant] = {"Centrale Électrique", "Usine d'Électricité"};
-        buildingNames[TypeBatiment::WaterTreatmentPlant] = {"Station d'Épuration", "Usine de Traitement d'Eau"};
-        buildingNames[TypeBatiment::UtilityPlant] = {"Usine des Services", "Complexe des Services"};
-        initialized = true;
+        auto& liste = buildingNames[static_cast<size_t>(source.type)];
+        for (const std::string& name : names)
+            liste.push_back(TableNoms::get(TableNoms::interner(name)));
     }
+    // Les listes sont écrites avant qu'un tirage ne puisse les lire
+    pret.store(true, std::memory_order_release);
 }
 
 // Implémentation 
-std::string NameGenerator::getRandomName(TypeBatiment type) {
-    initializeNames();
-    
-    auto it = buildingNames.find(type);
-    if (it == buildingNames.end() || it->second.empty()) {
-        return "Bâtiment Sans Nom";
+std::string_view NameGenerator::getRandomName(TypeBatiment type) {
+    if (!pret.load(std::memory_order_acquire))
+        throw std::logic_error("NameGenerator : tirage avant initializeNames()");
+
+    const auto& names = buildingNames[static_cast<size_t>(type)];
+    if (names.empty()) {
+        // Interné au premier besoin, sans verrou ensuite
+        static const std::string_view sansNom =
+            TableNoms::get(TableNoms::interner("Bâtiment Sans Nom"));
+        return sansNom;
     }
 
-    std::uniform_int_distribution<> dis(0, it->second.size() - 1);
-    return it->second[dis(gen)];
+    thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<size_t> dis(0, names.size() - 1);
+    return names[dis(gen)];
 }
@@ -1,9 +1,14 @@
 #include "../include/ville/ville.hpp"
 #include "../include/buildings/batiment.hpp"
 #include "../include/buildings/commercial.hpp"
+#include "../include/buildings/infrastructure.hpp"
+#include "../include/buildings/parc.hpp"
 #include "../include/buildings/resident.hpp"
 #include "../include/buildings/service.hpp"
+#include "../include/buildings/traits.hpp"
 #include "../include/utils.hpp"
+#include "../include/cycle/parallele.hpp"
+#include "../include/ville/arene.hpp"
 #include <memory>
 #include <string>
 #include <vector>
@@ -14,17 +19,85 @@ using namespace std;
 
 // Constructor
 Ville::Ville(const string &nom, double budget, unsigned int population,
-             Resources resources, BatimentList batiments)
-    : nom(nom), budget(budget), population(population), satisfaction(50),
-      polution(0), resources(resources), batiments(std::move(batiments)) {}
+             Resources resources, BatimentList batiments, int largeurCarte,
+             int hauteurCarte)
+    : arene(std::make_unique<AreneBatiments>()),
+      batiments(std::move(batiments)), nom(nom), budget(budget),
+      population(population), satisfaction(50), polution(0),
+      resources(resources),
+      champPollution(largeurCarte, hauteurCarte),
+      routes(largeurCarte, hauteurCarte), trafic(largeurCarte, hauteurCarte),
+      agrements(largeurCarte, hauteurCarte) {
+  dependances.declarer(Derivee::Pollution,
+                       {Entree::Batiments, Entree::Habitants,
+                        Entree::Population, Entree::Pollution,
+                        Entree::Champ});
+  dependances.declarer(Derivee::Satisfaction,
+                       {Entree::Batiments, Entree::Habitants,
+                        Entree::Population, Entree::Emplois, Entree::Pollution,
+                        Entree::Satisfaction, Entree::Trafic});
+  dependances.declarer(Derivee::Ressources,
+                       {Entree::Batiments, Entree::Emplois,
+                        Entree::Ressources});
+  dependances.declarer(Derivee::Profit,
+                       {Entree::Batiments, Entree::Emplois, Entree::Pollution});
+  dependances.declarer(Derivee::Population,
+                       {Entree::Batiments, Entree::Habitants,
+                        Entree::Population, Entree::Emplois, Entree::Pollution,
+                        Entree::Satisfaction});
+  for (auto &batiment : this->batiments)
+    indexerBatiment(batiment.get());
+}
 
+// Out of line, where AreneBatiments is complete
 Ville::~Ville() = default;
 
+AreneBatiments &Ville::getArene() { return *arene; }
+
 // List de batiments
 void Ville::ajoutBatiment(BatPtr batiment) {
+    Batiment *bat = batiment.get();
     batiments.push_back(std::move(batiment));
-    // Immediately reassign jobs to include new building's employees
-    assignerEmplois();
+    indexerBatiment(bat);
+    // Reassign jobs to include new building's employees
+    modificationEffectuee();
+}
+
+void Ville::ajoutBatiments(std::span<BatPtr> nouveaux) {
+  debutModifications();
+  batiments.reserve(batiments.size() + nouveaux.size());
+  for (auto &batiment : nouveaux) {
+    if (!batiment)
+      continue;
+    Batiment *bat = batiment.get();
+    batiments.push_back(std::move(batiment));
+    indexerBatiment(bat);
+    modificationEffectuee();
+  }
+  finModifications();
+}
+
+void Ville::debutModifications() { ++modificationsEnCours; }
+
+void Ville::finModifications() {
+  if (modificationsEnCours == 0)
+    return;
+  if (--modificationsEnCours == 0 && modificationsEnAttente)
+    appliquerModifications();
+}
+
+void Ville::modificationEffectuee() {
+  modificationsEnAttente = true;
+  if (modificationsEnCours == 0)
+    appliquerModifications();
+}
+
+// Recompute derived state after an edit (or a whole batch of them)
+void Ville::appliquerModifications() {
+  modificationsEnAttente = false;
+  ++revision;
+  dependances.signaler(Entree::Batiments);
+  assignerEmplois();
 }
 
 
@@ -33,9 +106,10 @@ void Ville::supprimerBatiment(int x , int y) {
     Position pos = (*it)->position;
     if (pos.x == x && pos.y == y) {
       budget += (*it)->getCost();
+      desindexerBatiment(it->get());
       batiments.erase(it);
-      // Immediately reassign jobs to remaining buildings
-      assignerEmplois();
+      // Reassign jobs to remaining buildings
+      modificationEffectuee();
       return;
     }
   }
@@ -43,39 +117,17 @@ void Ville::supprimerBatiment(int x , int y) {
 
 //pollution calculations
 float Ville::calculerPolutionTotale() {
+  if (!dependances.aRecalculer(Derivee::Pollution))
+    return polution;
   float pollutionTotale = 0.0f;
   
-  // Buildings generate pollution based on type
-  for (auto& batiment : batiments) {
-    // Power plants are major polluters
-    if (batiment->type == TypeBatiment::PowerPlant) {
-      pollutionTotale += 15.0f; // Significant pollution
-    }
-    // Commercial-like buildings (mall, cinema, bank) cause moderate pollution
-    else if (batiment->type == TypeBatiment::Mall ||
-             batiment->type == TypeBatiment::Cinema ||
-             batiment->type == TypeBatiment::Bank) {
-      pollutionTotale += 5.0f; // Moderate pollution
-    }
-    else if (batiment->type == TypeBatiment::House ||
-             batiment->type == TypeBatiment::Apartment) {
-      // Residential buildings generate minimal pollution themselves
-      pollutionTotale += 2.0f;
-    }
-    
-    // Occupied buildings generate more pollution
-    if (batiment->type == TypeBatiment::House ||
-        batiment->type == TypeBatiment::Apartment) {
-      Resident *r = dynamic_cast<Resident *>(batiment.get());
-      if (r) {
-        // More residents = more waste
-        float occupancyRatio = static_cast<float>(r->gethabitantsActuels()) / 
-                              static_cast<float>(r->getcapaciteHabitants() + 1);
-        pollutionTotale += occupancyRatio * 3.0f;
-      }
-    }
-  }
-  
+  // Buildings generate pollution based on type, weighed by how much of it
+  // reaches where people live; occupied homes more (more residents = more
+  // waste)
+  pollutionTotale += static_cast<float>(
+      colonnes.sommePollution() * calculerExpositionPollution() +
+      colonnes.sommeOccupation() * 3.0);
+
   // Population contributes to pollution (traffic, waste, etc.)
   float populationPollution = (population / 100.0f) * 0.5f;
   pollutionTotale += populationPollution;
@@ -91,8 +143,56 @@ float Ville::calculerPolutionTotale() {
   return pollutionTotale;
 }
 
+// Field at the homes, weighted by occupants (or evenly while nobody is
+// housed), relative to the field at the polluting tiles: 1 when people live
+// next to what pollutes, less when they live away from it or behind parks
+float Ville::calculerExpositionPollution() const {
+  float sources = champPollution.moyenneSources();
+  if (sources <= 0.0f)
+    return 1.0f;
+  bool parOccupants = populationLogee > 0;
+  double somme = 0.0;
+  double poids = 0.0;
+  for (Resident *r : residences.toutes()) {
+    double w = parOccupants ? r->gethabitantsActuels() : 1.0;
+    if (w == 0.0)
+      continue;
+    somme += w * champPollution.valeur(r->position.x, r->position.y);
+    poids += w;
+  }
+  if (poids == 0.0)
+    return 1.0f;
+  return static_cast<float>(somme / poids) / sources;
+}
+
+// Spread and decay the per-tile pollution for one cycle
+void Ville::diffuserPollution() {
+  static constexpr int ETAPES_PAR_CYCLE = 8;
+  if (!sourcesPollutionValides || revisionSourcesPollution != revision)
+    placerSourcesPollution();
+  if (champPollution.simuler(ETAPES_PAR_CYCLE))
+    dependances.signaler(Entree::Champ);
+}
+
+void Ville::placerSourcesPollution() {
+  champPollution.reinitialiserSources();
+  for (auto &batiment : batiments) {
+    if (batiment->type == TypeBatiment::Park) {
+      static_cast<Parc *>(batiment.get())->diminuerPollution();
+    } else if (batiment->getPolution() > 0.0f) {
+      champPollution.ajouterSource(batiment->position, batiment->surface,
+                                   batiment->getPolution() *
+                                       Batiment::BUILDING_POLLUTION_FACTOR);
+    }
+  }
+  revisionSourcesPollution = revision;
+  sourcesPollutionValides = true;
+}
+
 //Satisfaction Calculations
 int Ville::calculerSatisfactionTotale() {
+  if (!dependances.aRecalculer(Derivee::Satisfaction))
+    return satisfaction;
   // Use city population to determine if we should compute satisfaction
   unsigned int popVille = getPopulation();
   if (popVille == 0) {
@@ -106,16 +206,8 @@ int Ville::calculerSatisfactionTotale() {
   
   //positive factors
 
-  // Services & Amenities from buildings
-  for (auto& batiment : batiments) {
-    if (batiment->type == TypeBatiment::Park) {
-      satisfactionScore += 8.0f; // Parks improve happiness
-    } else if (batiment->type == TypeBatiment::Cinema ||
-               batiment->type == TypeBatiment::Mall ||
-               batiment->type == TypeBatiment::Bank) {
-      satisfactionScore += 5.0f; // Commerce/leisure provides enjoyment
-    }
-  }
+  // Services & Amenities near residents' homes
+  satisfactionScore += calculerBonusAgrements();
   
   // Population capacity satisfaction
   int capaciteTotale = calculerCapacitePopulation();
@@ -139,6 +231,10 @@ int Ville::calculerSatisfactionTotale() {
   float unemploymentPenalty = unemploymentRate * 0.2f;
   satisfactionScore -= unemploymentPenalty;
 
+  // Commuters stuck in traffic: doubling the trip time costs 15 points
+  if (traficActif)
+    satisfactionScore -= std::min(15.0f, trafic.getRetardRelatif() * 15.0f);
+
   // Pollution heavily impacts satisfaction (quadratic effect for realism)
   float pollutionFactor = (polution / 100.0f);
   float pollutionPenalty = pollutionFactor * pollutionFactor * 50.0f;
@@ -152,67 +248,89 @@ int Ville::calculerSatisfactionTotale() {
   return finalSatisfaction;
 }
 
+// Average amenity bonus over residences, weighted by occupants (or evenly
+// while nobody is housed yet)
+float Ville::calculerBonusAgrements() {
+  agrements.actualiser();
+  bool parOccupants = populationLogee > 0;
+  double somme = 0.0;
+  double poids = 0.0;
+  for (Resident *r : residences.toutes()) {
+    double w = parOccupants ? r->gethabitantsActuels() : 1.0;
+    if (w == 0.0)
+      continue;
+    int x = r->position.x, y = r->position.y;
+    float bonus = 0.0f;
+    for (int a = 0; a < CarteAgrements::NOMBRE; ++a)
+      bonus += BONUS_AGREMENT[a] *
+               agrements.couverture(static_cast<Agrement>(a), x, y);
+    somme += w * bonus;
+    poids += w;
+  }
+  return poids > 0.0 ? static_cast<float>(somme / poids) : 0.0f;
+}
+
+float Ville::getCouvertureAgrement(Agrement agrement, int x, int y) const {
+  agrements.actualiser();
+  return agrements.couverture(agrement, x, y);
+}
+
 // calculations
 Resources Ville::calculerconsommationTotale() {
-  Resources ConsumationTotale;
-  for (auto it = batiments.begin(); it != batiments.end(); ++it) {
-    ConsumationTotale += (*it)->getconsommation();
-  }
-  return ConsumationTotale;
+  return colonnes.sommeConsommation();
 }
 
 Resources Ville::calculerResourcesTotale() {
   Resources ResourcesTotale;
   for (auto it = batiments.begin(); it != batiments.end(); ++it) {
-    if ((*it)->type == TypeBatiment::PowerPlant ||
-        (*it)->type == TypeBatiment::WaterTreatmentPlant) {
-      ResourcesTotale += (*it)->getconsommation();
+    if (traitsDe((*it)->type).centrale) {
+      ResourcesTotale +=
+          static_cast<Infrastructure *>(it->get())->getProductionEffective();
     }
   }
-  setResources(resources);
   return ResourcesTotale;
 }
 
-int Ville::calculerPopulationTotale() const {
-  int populationTotale = 0;
-  for (auto it = batiments.begin(); it != batiments.end(); ++it) {
-    if ((*it)->type == TypeBatiment::House ||
-        (*it)->type == TypeBatiment::Apartment) {
-      Resident *r = dynamic_cast<Resident *>(it->get());
-      if (r)
-        populationTotale += r->gethabitantsActuels();
-    }
-  }
-  return populationTotale;
+// Resources left over (or missing) after this cycle's distribution
+void Ville::distribuerRessources() {
+  if (!dependances.aRecalculer(Derivee::Ressources))
+    return;
+  reseau.distribuer();
+  setResources(reseau.getProductionTotale() - reseau.getDemandeTotale());
 }
 
-int Ville::calculerCapacitePopulation() const {
-  int capaciteTotale = 0;
-  for (auto it = batiments.begin(); it != batiments.end(); ++it) {
-    if ((*it)->type == TypeBatiment::House ||
-        (*it)->type == TypeBatiment::Apartment) {
-      Resident *r = dynamic_cast<Resident *>(it->get());
-      if (r)
-        capaciteTotale += r->getcapaciteHabitants();
-    }
-  }
-  return capaciteTotale;
+Resources Ville::getPenurie(const Batiment *batiment) const {
+  return reseau.getPenurie(batiment);
 }
 
+Resources Ville::getPenurieTotale() const { return reseau.getPenurieTotale(); }
+
+int Ville::calculerPopulationTotale() const { return populationLogee; }
+
+int Ville::calculerCapacitePopulation() const { return capaciteLogement; }
+
+// Same as summing Comercial::getProfit over the shops. The income only
+// moves with the shops, their staff and the pollution (or the tuning)
 double Ville::calculerProfit() {
-  double profitTotale = 0.0;
-  for (auto it = batiments.begin(); it != batiments.end(); ++it) {
-    Comercial *c = dynamic_cast<Comercial *>(it->get());
-    if (c)
-      profitTotale += c->getProfit();
-  }
-  return profitTotale;
+  bool aJour = !dependances.aRecalculer(Derivee::Profit);
+  if (aJour && efficaciteProfit == Comercial::EMPLOYEE_EFFICIENCY &&
+      penaliteProfit == Comercial::POLLUTION_PENALTY)
+    return profit;
+  efficaciteProfit = Comercial::EMPLOYEE_EFFICIENCY;
+  penaliteProfit = Comercial::POLLUTION_PENALTY;
+  facteurProfit = 1.0f - (polution * penaliteProfit / 100.0f);
+  profit = colonnes.sommeRevenus(efficaciteProfit) * facteurProfit;
+  return profit;
 }
 
+double Ville::getFacteurProfit() const { return facteurProfit; }
+
 void Ville::collectProfit() { budget += calculerProfit(); }
 
 //population update
 void Ville::updatePopulation() {
+  if (!dependances.aRecalculer(Derivee::Population))
+    return;
   int capaciteTotale = calculerCapacitePopulation();
   // Distinguish between city population and actual occupants in buildings
   int popDansBatiments = calculerPopulationTotale();
@@ -224,18 +342,8 @@ void Ville::updatePopulation() {
     setPopulation(capaciteTotale);
     // Remove excess inhabitants from buildings
     int toRemove = popDansBatiments - capaciteTotale;
-    if (toRemove > 0) {
-      for (auto it = batiments.begin(); it != batiments.end() && toRemove > 0; ++it) {
-        if ((*it)->type == TypeBatiment::House || (*it)->type == TypeBatiment::Apartment) {
-          Resident *r = dynamic_cast<Resident *>(it->get());
-          if (r && r->gethabitantsActuels() > 0) {
-            int remove = std::min(r->gethabitantsActuels(), toRemove);
-            r->retirerHabitants(remove);
-            toRemove -= remove;
-          }
-        }
-      }
-    }
+    if (toRemove > 0)
+      retirerHabitants(toRemove);
     // If capacity is 0, we're done - population is now 0
     if (capaciteTotale == 0) {
       return;
@@ -300,32 +408,10 @@ void Ville::updatePopulation() {
   // Distribute population into resident buildings relative to current occupants
   int difference = nouvellePopulation - popDansBatiments;
 
-  if (difference > 0) {
-    for (auto it = batiments.begin(); it != batiments.end() && difference > 0; ++it) {
-      if ((*it)->type == TypeBatiment::House || (*it)->type == TypeBatiment::Apartment) {
-        Resident *r = dynamic_cast<Resident *>(it->get());
-        if (r && r->gethabitantsActuels() < r->getcapaciteHabitants()) {
-          int spacesAvailable = r->getcapaciteHabitants() - r->gethabitantsActuels();
-          int toAdd = std::min(spacesAvailable, difference);
-          r->ajouterHabitants(toAdd);
-          difference -= toAdd;
-        }
-      }
-    }
-  } else if (difference < 0) {
-    difference = -difference;
-    for (auto it = batiments.begin(); it != batiments.end() && difference > 0; ++it) {
-      if ((*it)->type == TypeBatiment::House || (*it)->type == TypeBatiment::Apartment) {
-        Resident *r = dynamic_cast<Resident *>(it->get());
-        if (r && r->gethabitantsActuels() > 0) {
-          int habitants = r->gethabitantsActuels();
-          int toRemove = std::min(habitants, difference);
-          r->retirerHabitants(toRemove);
-          difference -= toRemove;
-        }
-      }
-    }
-  }
+  if (difference > 0)
+    logerHabitants(difference);
+  else if (difference < 0)
+    retirerHabitants(-difference);
 
   setPopulation(nouvellePopulation);
   
@@ -335,6 +421,49 @@ void Ville::updatePopulation() {
   }
 }
 
+// Move people in, following the fill policy; returns how many were housed
+int Ville::logerHabitants(int nombre) {
+  int loges = 0;
+  while (loges < nombre) {
+    Resident *r = residences.prochaineLibre(politiqueRemplissage);
+    if (!r)
+      break;
+    int libre = r->getcapaciteHabitants() - r->gethabitantsActuels();
+    int ajout = politiqueRemplissage == PolitiqueRemplissage::Compacte
+                    ? std::min(libre, nombre - loges)
+                    : 1;
+    modifierHabitants(r, ajout);
+    loges += ajout;
+  }
+  return loges;
+}
+
+// Move people out, following the fill policy; returns how many left
+int Ville::retirerHabitants(int nombre) {
+  int partis = 0;
+  while (partis < nombre) {
+    Resident *r = residences.prochaineOccupee(politiqueRemplissage);
+    if (!r)
+      break;
+    int retrait = politiqueRemplissage == PolitiqueRemplissage::Compacte
+                      ? std::min(r->gethabitantsActuels(), nombre - partis)
+                      : 1;
+    modifierHabitants(r, -retrait);
+    partis += retrait;
+  }
+  return partis;
+}
+
+void Ville::setPolitiqueRemplissage(PolitiqueRemplissage politique) {
+  politiqueRemplissage = politique;
+}
+
+PolitiqueRemplissage Ville::getPolitiqueRemplissage() const {
+  return politiqueRemplissage;
+}
+
+void Ville::setSuiviDependances(bool actif) { dependances.setActif(actif); }
+
 // Getters
 string Ville::getNom() const { return nom; }
 double Ville::getBudget() const { return budget; }
@@ -342,6 +471,24 @@ float Ville::getPolution() const { return polution; }
 unsigned int Ville::getPopulation() const { return population; }  
 int Ville::getSatisfaction() const { return satisfaction; }
 Resources Ville::getResources() const { return resources; }
+unsigned long Ville::getRevision() const { return revision; }
+
+Batiment *Ville::getBatimentById(int id) const { return handles.get(id); }
+
+unsigned int Ville::getNombreBatiments(TypeBatiment type) const {
+  return batimentsParType[static_cast<size_t>(type)];
+}
+
+unsigned long Ville::getBatimentsAjoutes() const { return batimentsAjoutes; }
+
+unsigned long Ville::getBatimentsRetires() const { return batimentsRetires; }
+float Ville::getPollutionTuile(int x, int y) const {
+  return champPollution.valeur(x, y);
+}
+const ChampPollution &Ville::getChampPollution() const {
+  return champPollution;
+}
+ChampPollution &Ville::getChampPollution() { return champPollution; }
 
 
 Batiment* Ville::getBatimentByPos(int x, int y) const {
@@ -364,46 +511,33 @@ Batiment* Ville::getBatimentByPos(int x, int y) const {
 // Setters
 void Ville::setBudget(double newBudget) { budget = newBudget; }
 void Ville::setPopulation(unsigned int newPopulation) {
+  if (population != newPopulation)
+    dependances.signaler(Entree::Population);
   population = newPopulation;
 }
 void Ville::setSatisfaction(int newSatisfaction) {
-  satisfaction = std::max(0, std::min(100, newSatisfaction));
+  newSatisfaction = std::max(0, std::min(100, newSatisfaction));
+  if (satisfaction != newSatisfaction)
+    dependances.signaler(Entree::Satisfaction);
+  satisfaction = newSatisfaction;
 }
 void Ville::setPolution(float newPolution) { 
-  polution = std::max(0.0f, std::min(100.0f, newPolution)); 
+  newPolution = std::max(0.0f, std::min(100.0f, newPolution));
+  if (polution != newPolution)
+    dependances.signaler(Entree::Pollution);
+  polution = newPolution;
+}
+void Ville::setResources(Resources newResources) {
+  if (resources.eau != newResources.eau ||
+      resources.electricite != newResources.electricite)
+    dependances.signaler(Entree::Ressources);
+  resources = newResources;
 }
-void Ville::setResources(Resources newResources) { resources = newResources; }
 
 // employment calculations
-unsigned int Ville::calculerCapaciteEmploi() const {
-  unsigned int totalJobs = 0;
-  for (const auto &batiment : batiments) {
-    const Service *s = dynamic_cast<const Service *>(batiment.get());
-    if (s) {
-      // Count job slots from all buildings that hire
-      if (batiment->type == TypeBatiment::Cinema || 
-          batiment->type == TypeBatiment::Mall ||
-          batiment->type == TypeBatiment::Bank ||
-          batiment->type == TypeBatiment::PowerPlant ||
-          batiment->type == TypeBatiment::WaterTreatmentPlant ||
-          batiment->type == TypeBatiment::Park) {
-        totalJobs += s->getEmployeesNeeded();
-      }
-    }
-  }
-  return totalJobs;
-}
+unsigned int Ville::calculerCapaciteEmploi() const { return capaciteEmploi; }
 
-unsigned int Ville::calculerEmploiActuel() const {
-  unsigned int employed = 0;
-  for (const auto &batiment : batiments) {
-    const Service *s = dynamic_cast<const Service *>(batiment.get());
-    if (s) {
-      employed += s->getEmployees();
-    }
-  }
-  return employed;
-}
+unsigned int Ville::calculerEmploiActuel() const { return emploiActuel; }
 
 float Ville::calculerTauxChomage() const {
   unsigned int pop = static_cast<unsigned int>(calculerPopulationTotale());
@@ -414,66 +548,578 @@ float Ville::calculerTauxChomage() const {
   return (unemployed / static_cast<float>(pop)) * 100.0f;
 }
 
+// Buildings that hire people
+bool Ville::estEmployeur(const Batiment &batiment) {
+  return traitsDe(batiment.type).employeur;
+}
+
+bool Ville::estResidence(const Batiment &batiment) {
+  return traitsDe(batiment.type).residence;
+}
+
+bool Ville::agrementDe(const Batiment &batiment, Agrement &agrement) {
+  const TraitsBatiment &traits = traitsDe(batiment.type);
+  agrement = traits.categorie;
+  return traits.agrement;
+}
+
+// Register a building in the running totals
+void Ville::indexerBatiment(Batiment *batiment) {
+  batiment->id = handles.allouer(batiment);
+  batiment->ligne = colonnes.ajouter(batiment);
+  ++batimentsParType[static_cast<size_t>(batiment->type)];
+  ++batimentsAjoutes;
+  reseau.ajouter(batiment);
+  Agrement agrement;
+  if (agrementDe(*batiment, agrement))
+    agrements.ajouter(agrement, batiment->position, batiment->surface);
+
+  if (estResidence(*batiment)) {
+    Resident *r = dynamic_cast<Resident *>(batiment);
+    if (r) {
+      populationLogee += r->gethabitantsActuels();
+      capaciteLogement += r->getcapaciteHabitants();
+      colonnes.setHabitants(r->ligne, r->gethabitantsActuels(),
+                            r->getcapaciteHabitants());
+      residences.ajouter(r);
+      grilleResidences.inserer(r);
+      regionsModifiees.insert(grilleResidences.cleCellule(r->position));
+      if (modeTrajet)
+        emploisModifies = true;
+    }
+    return;
+  }
+
+  Service *s = dynamic_cast<Service *>(batiment);
+  if (!s)
+    return;
+  if (!estEmployeur(*batiment)) {
+    s->setEmployees(0);
+    return;
+  }
+
+  Comercial *c = dynamic_cast<Comercial *>(s);
+  if (c)
+    colonnes.setRevenu(c->ligne, c->getProfitBase(),
+                       c->getEmployees() >= c->getEmployeesNeeded());
+  s->rangEmployeur = static_cast<uint32_t>(employeurs.size());
+  employeurs.push_back(s);
+  repartition.ajouter(s);
+  grilleEmployeurs.inserer(s);
+  invaliderTrajets(s->position);
+  capaciteEmploi += s->getEmployeesNeeded();
+  emploiActuel += s->getEmployees();
+  if (modeTrajet) {
+    // Hires through the residences around it, matched again
+    affecterEmployes(s, 0);
+    emploisModifies = true;
+  }
+}
+
+// Remove a building from the running totals
+void Ville::desindexerBatiment(Batiment *batiment) {
+  handles.liberer(batiment->id);
+  batiment->id = 0;
+  Batiment *deplace = colonnes.retirer(batiment->ligne);
+  if (deplace)
+    deplace->ligne = batiment->ligne;
+  --batimentsParType[static_cast<size_t>(batiment->type)];
+  ++batimentsRetires;
+  reseau.retirer(batiment);
+  Agrement agrement;
+  if (agrementDe(*batiment, agrement))
+    agrements.retirer(agrement, batiment->position, batiment->surface);
+
+  if (estResidence(*batiment)) {
+    Resident *r = dynamic_cast<Resident *>(batiment);
+    if (r) {
+      populationLogee -= r->gethabitantsActuels();
+      capaciteLogement -= r->getcapaciteHabitants();
+      residences.retirer(r);
+      grilleResidences.retirer(r);
+      candidatsTrajet.erase(r);
+      groupesTrafic.erase(r);
+      residencesARapparier.erase(r);
+      // Its commuters leave their jobs, the vacancies go to the neighbours
+      auto flux = fluxParResidence.find(r);
+      if (flux != fluxParResidence.end()) {
+        for (const Flux &f : flux->second) {
+          affecterEmployes(f.employeur,
+                           f.employeur->getEmployees() - f.travailleurs);
+          employeursLiberes.insert(f.employeur);
+        }
+        fluxParResidence.erase(flux);
+        fluxRetires = true;
+      }
+      if (modeTrajet)
+        emploisModifies = true;
+    }
+    return;
+  }
+
+  if (!estEmployeur(*batiment))
+    return;
+  Service *s = dynamic_cast<Service *>(batiment);
+  if (!s)
+    return;
+
+  uint32_t rang = s->rangEmployeur;
+  if (rang >= employeurs.size() || employeurs[rang] != s)
+    return;
+  employeurs[rang] = employeurs.back();
+  employeurs[rang]->rangEmployeur = rang;
+  employeurs.pop_back();
+  repartition.retirer(s);
+  grilleEmployeurs.retirer(s);
+  invaliderTrajets(s->position);
+  employeursLiberes.erase(s);
+  // Its commuters live within reach, they look for another job
+  for (long long region :
+       grilleResidences.cellulesVoisines(s->position, distanceTrajetMax)) {
+    const std::vector<Batiment *> *contenu = grilleResidences.cellule(region);
+    if (!contenu)
+      continue;
+    for (Batiment *residence : *contenu) {
+      auto flux = fluxParResidence.find(residence);
+      if (flux == fluxParResidence.end())
+        continue;
+      auto &liste = flux->second;
+      auto fin = std::remove_if(liste.begin(), liste.end(),
+                                [s](const Flux &f) { return f.employeur == s; });
+      fluxRetires |= fin != liste.end();
+      liste.erase(fin, liste.end());
+      residencesARapparier.insert(static_cast<Resident *>(residence));
+    }
+  }
+
+  capaciteEmploi -= s->getEmployeesNeeded();
+  emploiActuel -= s->getEmployees();
+  if (modeTrajet)
+    emploisModifies = true;
+}
+
+void Ville::affecterEmployes(Service *s, unsigned int count) {
+  if (s->getEmployees() != count)
+    dependances.signaler(Entree::Emplois);
+  emploiActuel = emploiActuel - s->getEmployees() + count;
+  s->setEmployees(count);
+  colonnes.setComplet(s->ligne, count >= s->getEmployeesNeeded());
+}
+
+void Ville::modifierHabitants(Resident *r, int delta) {
+  int avant = r->gethabitantsActuels();
+  if (delta > 0)
+    r->ajouterHabitants(delta);
+  else if (delta < 0)
+    r->retirerHabitants(-delta);
+  int difference = r->gethabitantsActuels() - avant;
+  if (difference != 0)
+    dependances.signaler(Entree::Habitants);
+  populationLogee += difference;
+  colonnes.setHabitants(r->ligne, r->gethabitantsActuels(),
+                        r->getcapaciteHabitants());
+  residences.actualiser(r);
+  // Where people live matters once commutes are modelled
+  if (modeTrajet && difference != 0) {
+    residencesARapparier.insert(r);
+    emploisModifies = true;
+  }
+}
+
 // job assignment
 void Ville::assignerEmplois() {
-  unsigned int availableWorkers = static_cast<unsigned int>(calculerPopulationTotale());
-  unsigned int totalJobs = calculerCapaciteEmploi();
-  
-  // Collect all buildings that employ people
-  std::vector<Service*> employers;
-  for (auto &batiment : batiments) {
-    Service *s = dynamic_cast<Service *>(batiment.get());
-    if (s && (batiment->type == TypeBatiment::Cinema || 
-              batiment->type == TypeBatiment::Mall ||
-              batiment->type == TypeBatiment::Bank ||
-              batiment->type == TypeBatiment::PowerPlant ||
-              batiment->type == TypeBatiment::WaterTreatmentPlant ||
-              batiment->type == TypeBatiment::Park)) {
-      employers.push_back(s);
-    } else if (s) {
-      s->setEmployees(0);
+  unsigned int availableWorkers = static_cast<unsigned int>(populationLogee);
+
+  if (!modeTrajet) {
+    // Proportional split: only the employers whose share moved since the
+    // last assignment are touched
+    repartition.repartir(availableWorkers, [this](Service *s,
+                                                  unsigned int count) {
+      affecterEmployes(s, count);
+    });
+    return;
+  }
+
+  // Nothing changed since the last matching
+  if (!emploisModifies && availableWorkers == travailleursAssignes)
+    return;
+  travailleursAssignes = availableWorkers;
+  assignerEmploisParTrajet();
+  emploisModifies = false;
+}
+
+// commute model
+void Ville::setModeTrajet(bool actif) {
+  if (modeTrajet == actif)
+    return;
+  modeTrajet = actif;
+  if (!actif)
+    setTrafic(false);
+  fluxTrajet.clear();
+  ++revisionFlux;
+  emploisModifies = true;
+  // The matching staffs the employers its own way
+  repartition.invalider();
+  reconstruireTrajets();
+  if (actif) {
+    for (long long region : grilleResidences.cellulesOccupees())
+      regionsModifiees.insert(region);
+  }
+}
+
+// Forget the flows, the next matching starts from empty employers
+void Ville::reconstruireTrajets() {
+  fluxParResidence.clear();
+  residencesARapparier.clear();
+  employeursLiberes.clear();
+  trajetsAReconstruire = true;
+}
+
+bool Ville::getModeTrajet() const { return modeTrajet; }
+
+void Ville::setParametresTrajet(int distanceMax,
+                                size_t employeursParResidence) {
+  distanceTrajetMax = std::max(0, distanceMax);
+  this->employeursParResidence = employeursParResidence;
+  for (long long region : grilleResidences.cellulesOccupees())
+    regionsModifiees.insert(region);
+  // Flows may now reach farther than an employer's neighbourhood
+  reconstruireTrajets();
+  if (modeTrajet)
+    emploisModifies = true;
+}
+
+// An employer appeared or vanished: residences that could reach it need new
+// candidate lists
+void Ville::invaliderTrajets(Position position) {
+  for (long long region :
+       grilleResidences.cellulesVoisines(position, distanceTrajetMax))
+    regionsModifiees.insert(region);
+}
+
+// Recompute the nearest employers of every residence in a modified region,
+// one region per task
+void Ville::actualiserCandidatsTrajet() {
+  if (regionsModifiees.empty())
+    return;
+
+  std::vector<const std::vector<Batiment *> *> regions;
+  regions.reserve(regionsModifiees.size());
+  for (long long region : regionsModifiees) {
+    const std::vector<Batiment *> *contenu = grilleResidences.cellule(region);
+    if (!contenu)
+      continue;
+    regions.push_back(contenu);
+    // Entries are created up front so workers never modify the map itself
+    for (Batiment *residence : *contenu) {
+      candidatsTrajet[residence];
+      residencesARapparier.insert(static_cast<Resident *>(residence));
     }
   }
-  
-  if (employers.empty() || availableWorkers == 0) {
-    // No jobs or no workers - set all to 0
-    for (auto* s : employers) {
-      s->setEmployees(0);
+  regionsModifiees.clear();
+
+  routes.preparer();
+  bool parRoute = routes.getNombreRoutes() > 0;
+  executerEnParallele(regions.size(), [&](size_t i) {
+    for (Batiment *residence : *regions[i]) {
+      auto &candidats = candidatsTrajet.find(residence)->second;
+      grilleEmployeurs.plusProches(residence->position,
+                                   employeursParResidence, distanceTrajetMax,
+                                   candidats);
+      if (!parRoute)
+        continue;
+      for (auto &[cout, employeur] : candidats)
+        cout = coutTrajet(*residence, *employeur, cout);
+      std::stable_sort(candidats.begin(), candidats.end(),
+                       [](const auto &a, const auto &b) {
+                         return a.first < b.first;
+                       });
+    }
+  });
+}
+
+// First road tile next to the building's footprint
+bool Ville::accesRoute(const Batiment &batiment, Position &acces) const {
+  int largeur = std::max(1, static_cast<int>(batiment.surface.longeur));
+  int hauteur = std::max(1, static_cast<int>(batiment.surface.largeur));
+  int x0 = batiment.position.x;
+  int y0 = batiment.position.y;
+  for (int dx = 0; dx < largeur; ++dx) {
+    if (routes.estRoute(x0 + dx, y0 - 1)) {
+      acces = Position(x0 + dx, y0 - 1);
+      return true;
+    }
+    if (routes.estRoute(x0 + dx, y0 + hauteur)) {
+      acces = Position(x0 + dx, y0 + hauteur);
+      return true;
     }
-    return;
   }
-  
-  if (availableWorkers >= totalJobs) {
-    // Enough workers to fill all jobs
-    for (auto* s : employers) {
-      s->setEmployees(s->getEmployeesNeeded());
+  for (int dy = 0; dy < hauteur; ++dy) {
+    if (routes.estRoute(x0 - 1, y0 + dy)) {
+      acces = Position(x0 - 1, y0 + dy);
+      return true;
     }
-  } else {
-    // Not enough workers - distribute proportionally
-    unsigned int workersAssigned = 0;
-    
-    // First pass: floor allocation to avoid over-allocation
-    for (auto* s : employers) {
-      unsigned int capacity = s->getEmployeesNeeded();
-      float proportion = static_cast<float>(capacity) / static_cast<float>(totalJobs);
-      unsigned int allocated = static_cast<unsigned int>(std::floor(availableWorkers * proportion));
-      allocated = std::min(allocated, capacity); // Don't exceed building capacity
-      s->setEmployees(allocated);
-      workersAssigned += allocated;
+    if (routes.estRoute(x0 + largeur, y0 + dy)) {
+      acces = Position(x0 + largeur, y0 + dy);
+      return true;
     }
-    
-    // Second pass: distribute remaining workers one by one
-    unsigned int remaining = availableWorkers - workersAssigned;
-    for (auto* s : employers) {
-      if (remaining == 0) break;
-      unsigned int current = s->getEmployees();
-      unsigned int capacity = s->getEmployeesNeeded();
-      if (current < capacity) {
-        s->setEmployees(current + 1);
-        remaining--;
+  }
+  return false;
+}
+
+// Walking costs the straight distance; when both ends touch connected
+// roads the trip is one tile to the road at each end plus the road length
+// travelled VITESSE_ROUTE times faster. The HPA* length can exceed the real
+// one by a few tiles per chunk crossed (see ReseauRoutier)
+int Ville::coutTrajet(const Batiment &depart, const Batiment &arrivee,
+                      int marche) const {
+  Position a, b;
+  if (!accesRoute(depart, a) || !accesRoute(arrivee, b))
+    return marche;
+  int route = routes.distance(a, b);
+  if (route < 0)
+    return marche;
+  return std::min(marche, 2 + (route + VITESSE_ROUTE - 1) / VITESSE_ROUTE);
+}
+
+bool Ville::ajouterRoute(int x, int y) {
+  if (getBatimentByPos(x, y) || !routes.ajouterRoute(Position(x, y)))
+    return false;
+  routesModifiees();
+  return true;
+}
+
+bool Ville::retirerRoute(int x, int y) {
+  if (!routes.retirerRoute(Position(x, y)))
+    return false;
+  routesModifiees();
+  return true;
+}
+
+bool Ville::estRoute(int x, int y) const { return routes.estRoute(x, y); }
+
+ReseauRoutier &Ville::getRoutes() { return routes; }
+
+const ReseauRoutier &Ville::getRoutes() const { return routes; }
+
+void Ville::setTrafic(bool actif) {
+  if (traficActif == actif)
+    return;
+  traficActif = actif;
+  dependances.signaler(Entree::Trafic);
+  if (actif) {
+    setModeTrajet(true);
+  } else {
+    trafic.vider();
+    groupesTrafic.clear();
+  }
+  revisionFluxTrafic = revisionFlux - 1; // agents are rebuilt on next run
+}
+
+bool Ville::getTrafic() const { return traficActif; }
+
+const TraficAgents &Ville::getAgentsTrafic() const { return trafic; }
+
+float Ville::getRetardTrafic(const Batiment *residence) const {
+  auto it = groupesTrafic.find(residence);
+  return it == groupesTrafic.end() ? 0.0f : trafic.getRetardGroupe(it->second);
+}
+
+void Ville::simulerTrafic() {
+  if (!traficActif)
+    return;
+  // The commute is deterministic: same commuters on the same roads, same
+  // delays as last time
+  if (revisionFluxTrafic == revisionFlux &&
+      revisionRoutesTrafic == routes.getRevision())
+    return;
+  construireTrafic();
+  float retard = trafic.getRetardRelatif();
+  trafic.simuler();
+  if (trafic.getRetardRelatif() != retard)
+    dependances.signaler(Entree::Trafic);
+}
+
+// One agent per worker whose home and job both touch the road network
+void Ville::construireTrafic() {
+  trafic.vider();
+  groupesTrafic.clear();
+  routes.preparer();
+
+  std::vector<std::vector<Position>> chemins(fluxTrajet.size());
+  executerEnParallele(fluxTrajet.size(), [&](size_t i) {
+    Position depart, arrivee;
+    if (accesRoute(*fluxTrajet[i].residence, depart) &&
+        accesRoute(*fluxTrajet[i].employeur, arrivee))
+      routes.chemin(depart, arrivee, chemins[i]);
+  });
+
+  for (size_t i = 0; i < fluxTrajet.size(); ++i) {
+    if (chemins[i].empty())
+      continue;
+    auto groupe = groupesTrafic
+                      .emplace(fluxTrajet[i].residence,
+                               static_cast<uint32_t>(groupesTrafic.size()))
+                      .first->second;
+    trafic.ajouterTrajet(chemins[i], fluxTrajet[i].travailleurs, groupe);
+  }
+  revisionFluxTrafic = revisionFlux;
+  revisionRoutesTrafic = routes.getRevision();
+}
+
+// A road can reroute any commute, every candidate list is redone
+void Ville::routesModifiees() {
+  for (long long region : grilleResidences.cellulesOccupees())
+    regionsModifiees.insert(region);
+  if (modeTrajet)
+    emploisModifies = true;
+  modificationEffectuee();
+}
+
+// Greedy matching: shortest commutes are served first, each residence only
+// considers its nearest employers. Flows are kept from one run to the next:
+// only the residences whose occupants or candidates changed are matched
+// again, then the unemployed next to employers that lost commuters fill the
+// vacancies. Each employer's staff is written once, with its final value.
+void Ville::assignerEmploisParTrajet() {
+  actualiserCandidatsTrajet();
+
+  std::unordered_map<Service *, unsigned int> effectifs; // planned staff
+  bool fluxModifies = fluxRetires;
+  fluxRetires = false;
+  if (trajetsAReconstruire) {
+    for (auto *s : employeurs)
+      effectifs[s] = 0;
+    for (Resident *r : residences.toutes())
+      residencesARapparier.insert(r);
+    trajetsAReconstruire = false;
+    fluxModifies = true;
+  }
+
+  // Sorted by position so the result does not depend on hashing
+  auto parPosition = [](const Batiment *a, const Batiment *b) {
+    return a->position.y != b->position.y ? a->position.y < b->position.y
+                                          : a->position.x < b->position.x;
+  };
+  std::vector<Resident *> aRapparier(residencesARapparier.begin(),
+                                     residencesARapparier.end());
+  residencesARapparier.clear();
+  std::sort(aRapparier.begin(), aRapparier.end(), parPosition);
+  std::vector<std::vector<Flux>> anciens(aRapparier.size());
+  for (size_t i = 0; i < aRapparier.size(); ++i) {
+    auto flux = fluxParResidence.find(aRapparier[i]);
+    if (flux == fluxParResidence.end())
+      continue;
+    for (const Flux &f : flux->second)
+      effectifs.try_emplace(f.employeur, f.employeur->getEmployees())
+          .first->second -= f.travailleurs;
+    anciens[i] = std::move(flux->second);
+    fluxParResidence.erase(flux);
+  }
+  apparierTrajets(aRapparier, effectifs);
+  for (size_t i = 0; i < aRapparier.size() && !fluxModifies; ++i) {
+    auto flux = fluxParResidence.find(aRapparier[i]);
+    fluxModifies = flux == fluxParResidence.end() ? !anciens[i].empty()
+                                                  : flux->second != anciens[i];
+  }
+
+  // Vacancies left behind go to the unemployed living within reach
+  for (auto &[s, effectif] : effectifs)
+    if (effectif < s->getEmployees())
+      employeursLiberes.insert(s);
+  std::unordered_set<Resident *> dejaApparies(aRapparier.begin(),
+                                              aRapparier.end());
+  std::unordered_set<Resident *> chomeurs;
+  for (Service *s : employeursLiberes) {
+    auto effectif = effectifs.find(s);
+    unsigned int prevu =
+        effectif == effectifs.end() ? s->getEmployees() : effectif->second;
+    if (prevu >= s->getEmployeesNeeded())
+      continue;
+    for (long long region :
+         grilleResidences.cellulesVoisines(s->position, distanceTrajetMax)) {
+      const std::vector<Batiment *> *contenu = grilleResidences.cellule(region);
+      if (!contenu)
+        continue;
+      for (Batiment *residence : *contenu) {
+        Resident *r = static_cast<Resident *>(residence);
+        if (!dejaApparies.count(r))
+          chomeurs.insert(r);
       }
     }
   }
+  employeursLiberes.clear();
+  std::vector<Resident *> voisins(chomeurs.begin(), chomeurs.end());
+  std::sort(voisins.begin(), voisins.end(), parPosition);
+  fluxModifies |= apparierTrajets(voisins, effectifs);
+
+  for (auto &[s, effectif] : effectifs)
+    if (s->getEmployees() != effectif)
+      affecterEmployes(s, effectif);
+
+  // Traffic is replayed only when the commuters changed
+  if (!fluxModifies)
+    return;
+  fluxTrajet.clear();
+  for (Resident *r : residences.toutes()) {
+    auto flux = fluxParResidence.find(r);
+    if (flux != fluxParResidence.end())
+      fluxTrajet.insert(fluxTrajet.end(), flux->second.begin(),
+                        flux->second.end());
+  }
+  ++revisionFlux;
+}
+
+// Place the workers of logements who have no job yet, nearest employers
+// first, on top of the staff planned in effectifs; true if anyone was hired
+bool Ville::apparierTrajets(
+    const std::vector<Resident *> &logements,
+    std::unordered_map<Service *, unsigned int> &effectifs) {
+  std::vector<int> travailleurs(logements.size(), 0);
+  std::vector<std::vector<std::pair<size_t, Service *>>> parDistance(
+      distanceTrajetMax + 1);
+  for (size_t i = 0; i < logements.size(); ++i) {
+    travailleurs[i] = logements[i]->gethabitantsActuels();
+    auto flux = fluxParResidence.find(logements[i]);
+    if (flux != fluxParResidence.end())
+      for (const Flux &f : flux->second)
+        travailleurs[i] -= static_cast<int>(f.travailleurs);
+    if (travailleurs[i] <= 0)
+      continue;
+    auto it = candidatsTrajet.find(logements[i]);
+    if (it == candidatsTrajet.end())
+      continue;
+    for (const auto &[distance, employeur] : it->second)
+      parDistance[distance].emplace_back(i,
+                                         static_cast<Service *>(employeur));
+  }
+
+  bool embauche = false;
+  for (const auto &paires : parDistance) {
+    for (const auto &[i, s] : paires) {
+      if (travailleurs[i] <= 0)
+        continue;
+      unsigned int &effectif =
+          effectifs.try_emplace(s, s->getEmployees()).first->second;
+      unsigned int libres = s->getEmployeesNeeded() - effectif;
+      if (libres == 0)
+        continue;
+      unsigned int embauches =
+          std::min(libres, static_cast<unsigned int>(travailleurs[i]));
+      effectif += embauches;
+      travailleurs[i] -= embauches;
+      embauche = true;
+      auto &flux = fluxParResidence[logements[i]];
+      auto meme = std::find_if(flux.begin(), flux.end(), [s](const Flux &f) {
+        return f.employeur == s;
+      });
+      if (meme != flux.end())
+        meme->travailleurs += embauches;
+      else
+        flux.push_back({logements[i], s, embauches});
+    }
+  }
+  return embauche;
 }
 
 // employment status display
@@ -485,12 +1131,7 @@ void Ville::afficherStatutEmploi() const {
   
   for (const auto &batiment : batiments) {
     const Service *s = dynamic_cast<const Service *>(batiment.get());
-    if (s && (batiment->type == TypeBatiment::Cinema || 
-              batiment->type == TypeBatiment::Mall ||
-              batiment->type == TypeBatiment::Bank ||
-              batiment->type == TypeBatiment::PowerPlant ||
-              batiment->type == TypeBatiment::WaterTreatmentPlant ||
-              batiment->type == TypeBatiment::Park)) {
+    if (s && estEmployeur(*batiment)) {
       
       unsigned int employed = s->getEmployees();
       unsigned int capacity = s->getEmployeesNeeded();
@@ -0,0 +1,116 @@
+#include "../include/buildings/commercial.hpp"
+#include "../include/buildings/infrastructure.hpp"
+#include "../include/buildings/parc.hpp"
+#include "../include/buildings/resident.hpp"
+#include "../include/buildings/traits.hpp"
+#include "../include/ville/colonnes.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+// City totals over 1M buildings: the loops Ville used before the columns
+// (one virtual call or dynamic_cast per building) against ColonnesBatiments,
+// for every kernel the processor runs. Build with make bench (-O2).
+
+namespace {
+
+// What calculerconsommationTotale, calculerPolutionTotale and
+// calculerProfit did before they summed the columns
+double anciennesBoucles(BatimentList &batiments) {
+  Resources consommation;
+  for (auto &batiment : batiments)
+    consommation += batiment->getconsommation();
+
+  float pollution = 0.0f;
+  for (auto &batiment : batiments) {
+    const TraitsBatiment &traits = traitsDe(batiment->type);
+    pollution += traits.pollution;
+    if (traits.residence) {
+      Resident *r = dynamic_cast<Resident *>(batiment.get());
+      if (r)
+        pollution += static_cast<float>(r->gethabitantsActuels()) /
+                     static_cast<float>(r->getcapaciteHabitants() + 1) * 3.0f;
+    }
+  }
+
+  double profit = 0.0;
+  for (auto &batiment : batiments) {
+    Comercial *c = dynamic_cast<Comercial *>(batiment.get());
+    if (c)
+      profit += c->getProfit();
+  }
+  return consommation.eau + consommation.electricite + pollution + profit;
+}
+
+double colonnesSommees(const ColonnesBatiments &colonnes) {
+  Resources consommation = colonnes.sommeConsommation();
+  return consommation.eau + consommation.electricite +
+         colonnes.sommePollution() + colonnes.sommeOccupation() * 3.0 +
+         colonnes.sommeRevenus(Comercial::EMPLOYEE_EFFICIENCY);
+}
+
+template <class Calcul> double chronometrer(int repetitions, Calcul calcul) {
+  volatile double puits = calcul(); // warm up
+  auto debut = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i)
+    puits = calcul();
+  (void)puits;
+  std::chrono::duration<double, std::milli> duree =
+      std::chrono::steady_clock::now() - debut;
+  return duree.count() / repetitions;
+}
+
+} // namespace
+
+int main() {
+  NameGenerator::initializeNames();
+  const size_t nombre = 1000000;
+  const int repetitions = 20;
+
+  // Filled the way Ville fills them when buildings are indexed, staffed
+  // and populated
+  std::mt19937 rng(47);
+  BatimentList batiments;
+  ColonnesBatiments colonnes;
+  for (size_t i = 0; i < nombre; ++i) {
+    switch (rng() % 4) {
+    case 0:
+      batiments.push_back(Resident::createHouse(nullptr, 0, 0));
+      break;
+    case 1:
+      batiments.push_back(Comercial::createMall(nullptr, 0, 0));
+      break;
+    case 2:
+      batiments.push_back(Infrastructure::createPowerPlant(nullptr, 0, 0));
+      break;
+    default:
+      batiments.push_back(Parc::createPark(nullptr, 0, 0));
+    }
+    Batiment *b = batiments.back().get();
+    uint32_t ligne = colonnes.ajouter(b);
+    if (Resident *r = dynamic_cast<Resident *>(b)) {
+      r->ajouterHabitants(rng() % (r->getcapaciteHabitants() + 1));
+      colonnes.setHabitants(ligne, r->gethabitantsActuels(),
+                            r->getcapaciteHabitants());
+    } else if (Comercial *c = dynamic_cast<Comercial *>(b)) {
+      c->setEmployees(rng() % (c->getEmployeesNeeded() + 1));
+      colonnes.setRevenu(ligne, c->getProfitBase(),
+                         c->getEmployees() >= c->getEmployeesNeeded());
+    }
+  }
+
+  double avant = chronometrer(repetitions, [&] {
+    return anciennesBoucles(batiments);
+  });
+  std::printf("totaux %zu batiments, boucles : %.3f ms\n", nombre, avant);
+  for (const char *noyau : {"scalar", "avx"}) {
+    if (!ColonnesBatiments::choisirJeuInstructions(noyau))
+      continue;
+    double apres = chronometrer(repetitions, [&] {
+      return colonnesSommees(colonnes);
+    });
+    std::printf("totaux %zu batiments, colonnes %-6s : %.3f ms (%.1fx)\n",
+                nombre, noyau, apres, avant / apres);
+  }
+  return 0;
+}
@@ -0,0 +1,30 @@
+#include "../include/ville/pollution.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+// Time per diffusion step on a 1024x1024 map, for every kernel the
+// processor runs. Build with make bench (-O2).
+
+int main() {
+  const int cote = 1024, etapes = 200;
+  for (const char *noyau : {"scalar", "sse2", "avx"}) {
+    if (!ChampPollution::choisirJeuInstructions(noyau))
+      continue;
+    ChampPollution champ(cote, cote);
+    std::mt19937 rng(30);
+    for (int i = 0; i < 5000; ++i)
+      champ.ajouterSource(Position(rng() % cote, rng() % cote), Surface(2, 2),
+                          static_cast<float>(rng() % 100));
+    champ.etape(); // warm up
+
+    auto debut = std::chrono::steady_clock::now();
+    for (int i = 0; i < etapes; ++i)
+      champ.etape();
+    std::chrono::duration<double, std::milli> duree =
+        std::chrono::steady_clock::now() - debut;
+    std::printf("pollution %dx%d, %-6s : %.3f ms par etape\n", cote, cote,
+                noyau, duree.count() / etapes);
+  }
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include "../include/buildings/commercial.hpp"
+#include "../include/buildings/infrastructure.hpp"
+#include "../include/buildings/parc.hpp"
+#include "../include/buildings/resident.hpp"
+#include "../include/buildings/traits.hpp"
+#include "../include/ville/colonnes.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// The AVX column sums must give the scalar sums bit for bit, as the
+// architecture notes promise, and both must match a plain loop up to
+// rounding. Short columns of random length exercise the scalar tails, a
+// long one the parallel chunks; incomes span several orders of magnitude
+// so a change in the order of the additions shows.
+
+namespace {
+
+int echecs = 0;
+
+struct Sommes {
+  double eau, electricite, pollution, occupation, revenus;
+};
+
+Sommes sommer(const ColonnesBatiments &colonnes) {
+  Resources consommation = colonnes.sommeConsommation();
+  return {consommation.eau, consommation.electricite,
+          colonnes.sommePollution(), colonnes.sommeOccupation(),
+          colonnes.sommeRevenus(Comercial::EMPLOYEE_EFFICIENCY)};
+}
+
+void comparer(const char *somme, size_t lignes, double attendu,
+              double obtenu) {
+  if (std::fabs(obtenu - attendu) <= 1e-9 * std::fabs(attendu))
+    return;
+  ++echecs;
+  std::printf("  echec (%zu lignes) : %s, boucle %.17g, colonnes %.17g\n",
+              lignes, somme, attendu, obtenu);
+}
+
+void verifierTaille(size_t lignes, std::mt19937 &rng) {
+  std::uniform_real_distribution<double> mantisse(1.0, 10.0);
+  std::vector<BatPtr> batiments;
+  ColonnesBatiments colonnes;
+  Sommes boucle = {};
+  for (size_t i = 0; i < lignes; ++i) {
+    switch (rng() % 4) {
+    case 0:
+      batiments.push_back(Resident::createHouse(nullptr, 0, 0));
+      break;
+    case 1:
+      batiments.push_back(Comercial::createMall(nullptr, 0, 0));
+      break;
+    case 2:
+      batiments.push_back(Infrastructure::createPowerPlant(nullptr, 0, 0));
+      break;
+    default:
+      batiments.push_back(Parc::createPark(nullptr, 0, 0));
+    }
+    Batiment *b = batiments.back().get();
+    uint32_t ligne = colonnes.ajouter(b);
+    boucle.eau += b->getconsommation().eau;
+    boucle.electricite += b->getconsommation().electricite;
+    boucle.pollution += traitsDe(b->type).pollution;
+
+    int habitants = rng() % 50, capacite = 1 + rng() % 60;
+    colonnes.setHabitants(ligne, habitants, capacite);
+    boucle.occupation += habitants / (capacite + 1.0);
+
+    double revenu = mantisse(rng) * std::pow(10.0, rng() % 9);
+    bool complet = rng() % 3 != 0;
+    colonnes.setRevenu(ligne, revenu, complet);
+    boucle.revenus +=
+        complet ? revenu : Comercial::EMPLOYEE_EFFICIENCY * revenu;
+  }
+
+  ColonnesBatiments::choisirJeuInstructions("scalar");
+  Sommes reference = sommer(colonnes);
+  comparer("eau", lignes, boucle.eau, reference.eau);
+  comparer("electricite", lignes, boucle.electricite, reference.electricite);
+  comparer("pollution", lignes, boucle.pollution, reference.pollution);
+  comparer("occupation", lignes, boucle.occupation, reference.occupation);
+  comparer("revenus", lignes, boucle.revenus, reference.revenus);
+
+  if (ColonnesBatiments::choisirJeuInstructions("avx")) {
+    Sommes avx = sommer(colonnes);
+    if (std::memcmp(&avx, &reference, sizeof(Sommes)) != 0) {
+      ++echecs;
+      std::printf("  echec (%zu lignes) : les sommes avx different des "
+                  "sommes scalaires\n",
+                  lignes);
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  NameGenerator::initializeNames();
+  std::mt19937 rng(47);
+  if (!ColonnesBatiments::choisirJeuInstructions("avx"))
+    std::printf("  avx absent, seule la boucle est comparee\n");
+
+  // Short columns, where the scalar tail weighs as much as the vector loop
+  for (int essai = 0; essai < 200; ++essai)
+    verifierTaille(1 + rng() % 40, rng);
+  verifierTaille(200003, rng);
+
+  std::printf("verif_colonnes : %s\n", echecs == 0 ? "ok" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include "../include/buildings/commercial.hpp"
+#include "../include/buildings/infrastructure.hpp"
+#include "../include/buildings/parc.hpp"
+#include "../include/buildings/resident.hpp"
+#include "../include/ville/ville.hpp"
+#include <cstdio>
+#include <random>
+
+// Two identical cities go through the same edits, events and end of cycle
+// phases, one skipping the values whose inputs did not change and the other
+// computing everything every cycle. Pollution, satisfaction, resources,
+// population, budget and profit must stay exactly the same. The edits are
+// far apart so that every value settles and gets skipped in between.
+
+namespace {
+
+int echecs = 0;
+
+void verifier(bool condition, const char *valeur, int cycle, double suivi,
+              double complet) {
+  if (condition)
+    return;
+  if (++echecs <= 20)
+    std::printf("  echec (cycle %d) : %s, suivi %.9g, sans suivi %.9g\n",
+                cycle, valeur, suivi, complet);
+}
+
+// The phases of Simulation::terminerCycle, in their serial order
+void terminerCycle(Ville &ville) {
+  ville.collectProfit();
+  ville.diffuserPollution();
+  ville.calculerPolutionTotale();
+  ville.assignerEmplois();
+  ville.distribuerRessources();
+  ville.simulerTrafic();
+  ville.calculerSatisfactionTotale();
+  ville.updatePopulation();
+}
+
+BatPtr creer(Ville &ville, unsigned int type, int x, int y) {
+  switch (type % 8) {
+  case 0:
+  case 1:
+  case 2:
+    return Resident::createHouse(&ville, x, y);
+  case 3:
+    return Comercial::createCinema(&ville, x, y);
+  case 4:
+    return Comercial::createBank(&ville, x, y);
+  case 5:
+    return Infrastructure::createPowerPlant(&ville, x, y);
+  case 6:
+    return Infrastructure::createWaterTreatmentPlant(&ville, x, y);
+  default:
+    return Parc::createPark(&ville, x, y);
+  }
+}
+
+void comparer(Ville &suivi, Ville &complet, int cycle) {
+  verifier(suivi.getPolution() == complet.getPolution(), "pollution", cycle,
+           suivi.getPolution(), complet.getPolution());
+  verifier(suivi.getSatisfaction() == complet.getSatisfaction(),
+           "satisfaction", cycle, suivi.getSatisfaction(),
+           complet.getSatisfaction());
+  verifier(suivi.getResources().eau == complet.getResources().eau, "eau",
+           cycle, suivi.getResources().eau, complet.getResources().eau);
+  verifier(suivi.getResources().electricite ==
+               complet.getResources().electricite,
+           "electricite", cycle, suivi.getResources().electricite,
+           complet.getResources().electricite);
+  verifier(suivi.getPopulation() == complet.getPopulation(), "population",
+           cycle, suivi.getPopulation(), complet.getPopulation());
+  verifier(suivi.calculerPopulationTotale() ==
+               complet.calculerPopulationTotale(),
+           "habitants", cycle, suivi.calculerPopulationTotale(),
+           complet.calculerPopulationTotale());
+  verifier(suivi.calculerEmploiActuel() == complet.calculerEmploiActuel(),
+           "emplois", cycle, suivi.calculerEmploiActuel(),
+           complet.calculerEmploiActuel());
+  verifier(suivi.getBudget() == complet.getBudget(), "budget", cycle,
+           suivi.getBudget(), complet.getBudget());
+  verifier(suivi.calculerProfit() == complet.calculerProfit(), "profit",
+           cycle, suivi.calculerProfit(), complet.calculerProfit());
+}
+
+} // namespace
+
+int main() {
+  NameGenerator::initializeNames();
+  for (bool trafic : {false, true}) {
+    Ville suivi("suivi", 10000.0, 300, Resources(0.0, 0.0), BatimentList{});
+    Ville complet("complet", 10000.0, 300, Resources(0.0, 0.0),
+                  BatimentList{});
+    complet.setSuiviDependances(false);
+
+    // Roads every 8 tiles, buildings in between
+    for (Ville *ville : {&suivi, &complet}) {
+      for (int i = 0; i < 64; ++i)
+        for (int r = 0; r < 64; r += 8) {
+          ville->ajouterRoute(i, r);
+          ville->ajouterRoute(r, i);
+        }
+      ville->setTrafic(trafic);
+    }
+
+    // Buildings first, then one edit or event every CALME cycles: long
+    // enough for the pollution field and the population to settle
+    const int CALME = 200;
+    std::mt19937 rng(49);
+    for (int cycle = 0; cycle < 20 + 12 * CALME; ++cycle) {
+      unsigned int action = cycle < 20             ? 0
+                            : cycle % CALME == 0 ? rng() % 7
+                                                 : 7;
+      unsigned int type = rng();
+      int x = 1 + 8 * (rng() % 8) + 3 * (rng() % 2);
+      int y = 1 + 8 * (rng() % 8) + 3 * (rng() % 2);
+      float valeur = static_cast<float>(rng() % 100);
+      for (Ville *ville : {&suivi, &complet}) {
+        if (action < 2)
+          ville->ajoutBatiment(creer(*ville, type, x, y));
+        else if (action == 2)
+          ville->supprimerBatiment(x, y);
+        else if (action == 3)
+          ville->setPolution(valeur); // what events do
+        else if (action == 4)
+          ville->setSatisfaction(static_cast<int>(valeur));
+        else if (action == 5)
+          ville->setPopulation(static_cast<unsigned int>(valeur) * 10);
+        else if (action == 6) // the commute model staffs its own way
+          ville->setModeTrajet(!ville->getModeTrajet());
+        // otherwise nothing changes before the end of the cycle
+      }
+      terminerCycle(suivi);
+      terminerCycle(complet);
+      comparer(suivi, complet, cycle);
+    }
+  }
+
+  std::printf("verif_dependances : %s\n", echecs == 0 ? "ok" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include "../include/buildings/commercial.hpp"
+#include "../include/ville/emplois.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Incremental splits (employers added or removed, workforce moving a little
+// or a lot) must staff every employer exactly as a split started over would.
+
+namespace {
+
+int echecs = 0;
+
+void verifier(bool condition, const char *message, int essai, int etape) {
+  if (condition)
+    return;
+  ++echecs;
+  std::printf("  echec (essai %d, etape %d) : %s\n", essai, etape, message);
+}
+
+BatPtr creerEmployeur(std::mt19937 &rng) {
+  switch (rng() % 3) {
+  case 0:
+    return Comercial::createBank(nullptr, 0, 0);
+  case 1:
+    return Comercial::createMall(nullptr, 0, 0);
+  default:
+    return Comercial::createCinema(nullptr, 0, 0);
+  }
+}
+
+} // namespace
+
+int main() {
+  NameGenerator::initializeNames();
+  std::mt19937 rng(26);
+  for (int essai = 0; essai < 50; ++essai) {
+    RepartitionEmplois repartition;
+    std::vector<BatPtr> employeurs; // in insertion order
+    unsigned int travailleurs = 0;
+
+    for (int etape = 0; etape < 400; ++etape) {
+      unsigned int operation = rng() % 6;
+      if (operation == 0 || employeurs.size() < 5) {
+        employeurs.push_back(creerEmployeur(rng));
+        repartition.ajouter(static_cast<Service *>(employeurs.back().get()));
+      } else if (operation == 1) {
+        size_t i = rng() % employeurs.size();
+        repartition.retirer(static_cast<Service *>(employeurs[i].get()));
+        employeurs.erase(employeurs.begin() + i);
+      } else if (operation == 2) {
+        travailleurs = rng() % 3000; // far enough to start over
+      } else {
+        int ecart = static_cast<int>(rng() % 9) - 4;
+        travailleurs = static_cast<unsigned int>(
+            std::max(0, static_cast<int>(travailleurs) + ecart));
+      }
+      repartition.repartir(travailleurs, [](Service *s, unsigned int n) {
+        s->setEmployees(n);
+      });
+
+      unsigned long long postes = 0, employes = 0;
+      for (const BatPtr &b : employeurs) {
+        const Service *s = static_cast<const Service *>(b.get());
+        postes += s->getEmployeesNeeded();
+        employes += s->getEmployees();
+        verifier(s->getEmployees() <= s->getEmployeesNeeded(),
+                 "employer staffed beyond its jobs", essai, etape);
+      }
+      verifier(employes == std::min<unsigned long long>(travailleurs, postes),
+               "staff is not min(workforce, jobs)", essai, etape);
+
+      // Same employers in the same order: any difference is reported
+      RepartitionEmplois reference;
+      for (const BatPtr &b : employeurs)
+        reference.ajouter(static_cast<Service *>(b.get()));
+      reference.invalider();
+      bool identique = true;
+      reference.repartir(travailleurs,
+                         [&](Service *, unsigned int) { identique = false; });
+      verifier(identique, "incremental split differs from a fresh one", essai,
+               etape);
+    }
+  }
+
+  std::printf("verif_emplois : %s\n", echecs == 0 ? "ok" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#include "../include/ville/pollution.hpp"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Every diffusion kernel the processor runs must give the scalar kernel's
+// field bit for bit. The width is not a multiple of 8 so the vector loops
+// end with a scalar tail.
+
+namespace {
+
+std::vector<float> simulerAvec(const char *noyau, int largeur, int hauteur) {
+  ChampPollution::choisirJeuInstructions(noyau);
+  ChampPollution champ(largeur, hauteur);
+  std::mt19937 rng(30);
+  for (int i = 0; i < 60; ++i)
+    champ.ajouterSource(Position(rng() % largeur, rng() % hauteur),
+                        Surface(1 + rng() % 3, 1 + rng() % 3),
+                        static_cast<float>(rng() % 100));
+  for (int i = 0; i < 10; ++i)
+    champ.ajouterPuits(Position(rng() % largeur, rng() % hauteur),
+                       Surface(2, 2), 0.3f);
+  champ.simuler(50);
+
+  std::vector<float> valeurs;
+  for (int y = 0; y < hauteur; ++y)
+    for (int x = 0; x < largeur; ++x)
+      valeurs.push_back(champ.valeur(x, y));
+  return valeurs;
+}
+
+} // namespace
+
+int main() {
+  const int largeur = 203, hauteur = 77;
+  std::vector<float> reference = simulerAvec("scalar", largeur, hauteur);
+
+  int echecs = 0;
+  for (const char *noyau : {"sse2", "avx"}) {
+    if (!ChampPollution::choisirJeuInstructions(noyau)) {
+      std::printf("  %s absent, ignore\n", noyau);
+      continue;
+    }
+    std::vector<float> valeurs = simulerAvec(noyau, largeur, hauteur);
+    if (std::memcmp(valeurs.data(), reference.data(),
+                    valeurs.size() * sizeof(float)) != 0) {
+      ++echecs;
+      std::printf("  echec : le noyau %s differe du noyau scalaire\n", noyau);
+    }
+  }
+
+  std::printf("verif_pollution : %s\n", echecs == 0 ? "ok" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
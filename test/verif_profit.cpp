@@ -0,0 +1,101 @@
+#include "../include/buildings/commercial.hpp"
+#include "../include/buildings/resident.hpp"
+#include "../include/ville/ville.hpp"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// The cached city income must stay the sum of what the shops report, as
+// staffing, pollution, the shops themselves and the income tuning change.
+// Totals are compared up to rounding: the city adds the shops in a
+// different order.
+
+namespace {
+
+int echecs = 0;
+
+void verifier(bool condition, const char *message, int etape, double ville,
+              double magasins) {
+  if (condition)
+    return;
+  if (++echecs <= 20)
+    std::printf("  echec (etape %d) : %s, ville %.9g, magasins %.9g\n",
+                etape, message, ville, magasins);
+}
+
+BatPtr creer(Ville &ville, unsigned int type, int x, int y) {
+  switch (type % 12) {
+  case 0:
+    return Comercial::createCinema(&ville, x, y);
+  case 1:
+    return Comercial::createMall(&ville, x, y);
+  case 2:
+    return Comercial::createBank(&ville, x, y);
+  default:
+    return Resident::createHouse(&ville, x, y);
+  }
+}
+
+} // namespace
+
+int main() {
+  NameGenerator::initializeNames();
+  const float efficacite = Comercial::EMPLOYEE_EFFICIENCY;
+  const float penalite = Comercial::POLLUTION_PENALTY;
+
+  Ville ville("profit", 10000.0, 0, Resources(0.0, 0.0), BatimentList{});
+  std::mt19937 rng(50);
+  int complets = 0, partiels = 0; // steps with a fully, a partly staffed shop
+
+  for (int etape = 0; etape < 2000; ++etape) {
+    int x = 4 * (rng() % 16), y = 4 * (rng() % 16);
+    unsigned int action = etape < 30 ? 0 : rng() % 7;
+    if (action == 0) {
+      ville.ajoutBatiment(creer(ville, rng(), x, y));
+    } else if (action == 1) {
+      ville.supprimerBatiment(x, y);
+    } else if (action == 2) { // people move in or out, staff follows
+      ville.setPopulation(rng() % (ville.calculerCapacitePopulation() + 1));
+      ville.updatePopulation();
+      ville.assignerEmplois();
+    } else if (action == 3) {
+      ville.setPolution(static_cast<float>(rng() % 1000) / 10.0f);
+    } else if (action == 4) {
+      Comercial::EMPLOYEE_EFFICIENCY = static_cast<float>(rng() % 100) / 100.0f;
+    } else if (action == 5) {
+      Comercial::POLLUTION_PENALTY = static_cast<float>(rng() % 100) / 100.0f;
+    } else { // nearest employers first instead of a proportional split
+      ville.setModeTrajet(!ville.getModeTrajet());
+      ville.assignerEmplois();
+    }
+
+    // The shops read the pollution factor of the last total, so the total
+    // comes first
+    double total = ville.calculerProfit();
+    double somme = 0.0;
+    bool complet = false, partiel = false;
+    for (const BatPtr &b : ville.batiments) {
+      const Comercial *c = dynamic_cast<const Comercial *>(b.get());
+      if (!c)
+        continue;
+      somme += c->getProfit();
+      (c->getEmployees() >= c->getEmployeesNeeded() ? complet : partiel) =
+          true;
+    }
+    complets += complet;
+    partiels += partiel;
+    verifier(std::fabs(total - somme) <= 1e-9 * std::fabs(somme),
+             "income differs from the sum over the shops", etape, total,
+             somme);
+    verifier(ville.calculerProfit() == total, "cached income moved", etape,
+             ville.calculerProfit(), total);
+  }
+  Comercial::EMPLOYEE_EFFICIENCY = efficacite;
+  Comercial::POLLUTION_PENALTY = penalite;
+
+  verifier(complets > 0 && partiels > 0,
+           "shops were never both fully and partly staffed", -1, complets,
+           partiels);
+  std::printf("verif_profit : %s\n", echecs == 0 ? "ok" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+#include "../include/ville/routes.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// HPA* distances against a breadth-first search over the road tiles, on a
+// few maps: roads crossing chunk borders, a dead end, a random network,
+// and the same network after roads were removed. Both must agree on what
+// is reachable, HPA* may never be shorter, and it may only be longer by
+// the detour to an entrance at each border the real path crosses.
+
+namespace {
+
+constexpr int C = ReseauRoutier::TAILLE_CHUNK;
+// A crossing at tile i of a border run reaches the nearest entrance of the
+// run and comes back on the other side: at most twice half a border
+constexpr int DETOUR_MAX = 2 * ((C - 1) / 2);
+
+int echecs = 0;
+int ecartMax = 0;
+long ecartTotal = 0, requetes = 0;
+
+void echec(const char *carte, const char *message, Position a, Position b,
+           int attendu, int obtenu) {
+  if (++echecs <= 20)
+    std::printf("  echec (%s) : %s, (%d,%d) -> (%d,%d), bfs %d, hpa %d\n",
+                carte, message, a.x, a.y, b.x, b.y, attendu, obtenu);
+}
+
+// Road distance from depart to every tile, and how many chunk borders the
+// path found crosses
+struct Parcours {
+  std::vector<int> distance;
+  std::vector<int> traversees;
+};
+
+Parcours parcourir(const ReseauRoutier &reseau, int largeur, int hauteur,
+                   Position depart) {
+  Parcours p;
+  p.distance.assign(largeur * hauteur, -1);
+  p.traversees.assign(largeur * hauteur, 0);
+  std::vector<int> file = {depart.y * largeur + depart.x};
+  p.distance[file[0]] = 0;
+  for (size_t i = 0; i < file.size(); ++i) {
+    int x = file[i] % largeur, y = file[i] / largeur;
+    const int voisins[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+    for (const auto &[vx, vy] : voisins) {
+      if (!reseau.estRoute(vx, vy))
+        continue;
+      int v = vy * largeur + vx;
+      if (p.distance[v] != -1)
+        continue;
+      p.distance[v] = p.distance[file[i]] + 1;
+      p.traversees[v] = p.traversees[file[i]] +
+                        (vx / C != x / C || vy / C != y / C ? 1 : 0);
+      file.push_back(v);
+    }
+  }
+  return p;
+}
+
+// The refined path has to be made of adjacent road tiles, as long as the
+// distance
+void verifierChemin(const char *carte, const ReseauRoutier &reseau,
+                    Position a, Position b, int distance) {
+  std::vector<Position> chemin;
+  bool trouve = reseau.chemin(a, b, chemin);
+  if (trouve != (distance >= 0)) {
+    echec(carte, "chemin disagrees with distance", a, b, distance,
+          trouve ? static_cast<int>(chemin.size()) - 1 : -1);
+    return;
+  }
+  if (!trouve)
+    return;
+  bool contigu = chemin.front().x == a.x && chemin.front().y == a.y &&
+                 chemin.back().x == b.x && chemin.back().y == b.y;
+  for (size_t i = 1; i < chemin.size(); ++i)
+    contigu = contigu && reseau.estRoute(chemin[i].x, chemin[i].y) &&
+              std::abs(chemin[i].x - chemin[i - 1].x) +
+                      std::abs(chemin[i].y - chemin[i - 1].y) ==
+                  1;
+  if (!contigu || static_cast<int>(chemin.size()) - 1 != distance)
+    echec(carte, "path is broken or not as long as the distance", a, b,
+          distance, static_cast<int>(chemin.size()) - 1);
+}
+
+void comparer(const char *carte, ReseauRoutier &reseau, int largeur,
+              int hauteur, std::mt19937 &rng, int departs) {
+  reseau.preparer();
+  std::vector<Position> routes;
+  for (int y = 0; y < hauteur; ++y)
+    for (int x = 0; x < largeur; ++x)
+      if (reseau.estRoute(x, y))
+        routes.push_back(Position(x, y));
+  if (routes.empty())
+    return;
+
+  for (int d = 0; d < departs; ++d) {
+    Position a = routes[rng() % routes.size()];
+    Parcours reference = parcourir(reseau, largeur, hauteur, a);
+    for (int q = 0; q < 40; ++q) {
+      Position b = routes[rng() % routes.size()];
+      int t = b.y * largeur + b.x;
+      int attendu = reference.distance[t];
+      int obtenu = reseau.distance(a, b);
+      ++requetes;
+      if ((attendu < 0) != (obtenu < 0)) {
+        echec(carte, "reachability differs", a, b, attendu, obtenu);
+        continue;
+      }
+      if (obtenu < attendu)
+        echec(carte, "shorter than the road distance", a, b, attendu, obtenu);
+      else if (obtenu - attendu > DETOUR_MAX * reference.traversees[t])
+        echec(carte, "longer than the entrance detours allow", a, b, attendu,
+              obtenu);
+      if (attendu >= 0) {
+        ecartMax = std::max(ecartMax, obtenu - attendu);
+        ecartTotal += obtenu - attendu;
+      }
+      if (q % 8 == 0)
+        verifierChemin(carte, reseau, a, b, obtenu);
+    }
+  }
+}
+
+void tracer(ReseauRoutier &reseau, int x0, int y0, int x1, int y1) {
+  for (int y = y0; y <= y1; ++y)
+    for (int x = x0; x <= x1; ++x)
+      reseau.ajouterRoute(Position(x, y));
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 rng(33);
+
+  // A 3 tile avenue and a 7 tile boulevard across every chunk: narrow
+  // border runs get one entrance, wide ones two
+  {
+    ReseauRoutier reseau(70, 50);
+    tracer(reseau, 0, 20, 69, 22);
+    tracer(reseau, 28, 0, 34, 49);
+    tracer(reseau, 5, 40, 60, 40);
+    tracer(reseau, 5, 30, 5, 40);
+    comparer("avenues", reseau, 70, 50, rng, 30);
+
+    // Cut them on each side of chunk borders: whatever is left beyond a cut
+    // is reached the long way round or not at all
+    for (int y = 20; y <= 22; ++y)
+      reseau.retirerRoute(Position(C, y)); // first column of a chunk
+    for (int x = 28; x <= 34; ++x)
+      reseau.retirerRoute(Position(x, 2 * C - 1)); // last row of a chunk
+    for (int y = 20; y <= 22; ++y)
+      reseau.retirerRoute(Position(4 * C - 1, y)); // last column
+    comparer("avenues coupees", reseau, 70, 50, rng, 30);
+  }
+
+  // A spur ending in a dead end next to the main road, and a road island
+  // that nothing reaches
+  {
+    ReseauRoutier reseau(64, 64);
+    tracer(reseau, 2, 5, 50, 5);
+    tracer(reseau, 40, 6, 40, 30);
+    tracer(reseau, 41, 30, 47, 30); // dead end, 1 tile from the next road
+    tracer(reseau, 49, 6, 49, 40);
+    tracer(reseau, 55, 55, 62, 55); // island
+    comparer("impasse", reseau, 64, 64, rng, 30);
+  }
+
+  // A random network, then the same after removing roads: the chunks
+  // rebuilt by preparer() must answer like a network built from scratch
+  {
+    const int largeur = 80, hauteur = 56;
+    ReseauRoutier reseau(largeur, hauteur);
+    for (int y = 0; y < hauteur; ++y)
+      for (int x = 0; x < largeur; ++x)
+        if (rng() % 100 < 58)
+          reseau.ajouterRoute(Position(x, y));
+    comparer("aleatoire", reseau, largeur, hauteur, rng, 60);
+
+    for (int i = 0; i < 400; ++i)
+      reseau.retirerRoute(Position(rng() % largeur, rng() % hauteur));
+    // A whole row along a chunk border too, splitting chunks apart
+    for (int x = 0; x < largeur; ++x)
+      reseau.retirerRoute(Position(x, C));
+    comparer("retraits", reseau, largeur, hauteur, rng, 60);
+
+    ReseauRoutier neuf(largeur, hauteur);
+    for (int y = 0; y < hauteur; ++y)
+      for (int x = 0; x < largeur; ++x)
+        if (reseau.estRoute(x, y))
+          neuf.ajouterRoute(Position(x, y));
+    neuf.preparer();
+    for (int q = 0; q < 3000; ++q) {
+      Position a(rng() % largeur, rng() % hauteur);
+      Position b(rng() % largeur, rng() % hauteur);
+      int attendu = neuf.distance(a, b);
+      int obtenu = reseau.distance(a, b);
+      if (attendu != obtenu)
+        echec("retraits", "rebuilt chunks differ from a fresh network", a, b,
+              attendu, obtenu);
+    }
+  }
+
+  std::printf("  %ld distances, HPA* longer by %.2f tiles on average, %d at "
+              "most\n",
+              requetes, requetes ? double(ecartTotal) / requetes : 0.0,
+              ecartMax);
+  std::printf("verif_routes : %s\n", echecs == 0 ? "ok" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}
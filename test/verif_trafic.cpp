@@ -0,0 +1,55 @@
+#include "../include/ville/trafic.hpp"
+#include <cstdio>
+#include <vector>
+
+// Delays of agents whose path is longer than the commute lasts. Alone on the
+// road they are never late; in a queue they are at least as late as on the
+// first part of the same path, which they all finish in time.
+
+namespace {
+
+int echecs = 0;
+
+void verifier(bool condition, const char *message, double attendu,
+              double obtenu) {
+  if (condition)
+    return;
+  ++echecs;
+  std::printf("  echec : %s (%.2f, %.2f)\n", message, attendu, obtenu);
+}
+
+std::vector<Position> ligne(int longueur) {
+  std::vector<Position> chemin;
+  for (int x = 0; x < longueur; ++x)
+    chemin.push_back(Position(x, 0));
+  return chemin;
+}
+
+float retardMoyen(int longueur, uint32_t agents) {
+  TraficAgents trafic(400, 1);
+  trafic.ajouterTrajet(ligne(longueur), agents, 0);
+  trafic.simuler();
+  return trafic.getRetardMoyen();
+}
+
+} // namespace
+
+int main() {
+  const int court = 150, long_ = 400; // long_ > PAS_MAX
+  static_assert(400 > TraficAgents::PAS_MAX);
+
+  verifier(retardMoyen(long_, 1) == 0.0f, "free road, cut off agent is late",
+           0.0, retardMoyen(long_, 1));
+
+  // The queue at the first tiles is the same on both paths: downstream
+  // tiles never hold agents back
+  float debut = retardMoyen(court, 600);
+  float complet = retardMoyen(long_, 600);
+  verifier(debut > 0.0f, "600 agents on one road and no delay", 0.0, debut);
+  verifier(complet >= debut,
+           "cut off agents less late than on the first part of their path",
+           debut, complet);
+
+  std::printf("verif_trafic : %s\n", echecs == 0 ? "ok" : "ECHEC");
+  return echecs == 0 ? 0 : 1;
+}